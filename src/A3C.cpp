@@ -1,22 +1,48 @@
 #pragma once
 #include "atfunc.cpp"
 #include "queue.cpp"
+#include "ring.cpp"
+#include "pool.cpp"
+#include "format.cpp"
+#include "frame.cpp"
+#include "convert.cpp"
+#include "metadata.cpp"
+#include "writer.cpp"
+#include "hdf5.cpp"
+#include "compress.cpp"
+#include "calibration.cpp"
+#include "coadd.cpp"
+#include "stream.cpp"
+#include <chrono>
 #include <ctime>
+#include <filesystem>
 #include <fstream>
 #include <thread>
 #include <vector>
+#include <memory>
+#include <map>
 
 using namespace std;
 
+// Number of index records collected before they are appended to the index file
+#define INDEX_BATCH_SIZE 1024
+
+// Fraction of a frame period a timestamp can be off by before the frame counts as late
+#define TIMING_TOLERANCE 0.25
+
+// Most frames whose stage latencies are kept when tracking them, so memory stays bounded
+#define LATENCY_SAMPLE_LIMIT 1000000
+
 /// @brief This class is for controlling an Andor SDK3 camera to rapidly take,
 /// process, and store frames, making use of multi-threading. It does this by
-/// running four threads: 
+/// running four sets of threads: 
 ///
 /// (1) Acquisition, which runs the camera
 ///
-/// (2) Processing, which sequentially takes each image captured by thread #1 and
-///     performs necessary processing (i.e., removing padding, extracting metadata
-///     etc)
+/// (2) Processing, which is a configurable number of worker threads that each take
+///     images captured by thread #1 and perform the necessary processing (i.e.,
+///     removing padding, extracting metadata etc), followed by a reordering thread
+///     that puts their output back into the order the frames were captured in
 ///
 /// (3) writing, which takes the output of (2) and writes it directly to disk, 
 ///     allowing its footprint in memory to freed
@@ -24,57 +50,188 @@ using namespace std;
 /// (4) monitoring, which keeps an eye on the other three threads and reports their 
 ///     performance to the user.
 ///
-/// There are two "FIFO" (First-In, First-Out) queues in-between threads #1-#2 and
-/// #2-#3. These are effectively pipelines between the threads, allowing for data
-/// flow between the threads in an orderly manner. If there is a bottleneck in the
-/// system (for instance, the writing thread only be able to write to disk at a
-/// fraction of the speed that frames are coming in), then one of both of these 
-/// queues will start to grow in size, and cause memory usage to steadily climb.
+/// There are "FIFO" (First-In, First-Out) queues in-between threads #1-#2 (one
+/// per worker, each way) and #2-#3. These are effectively pipelines between the
+/// threads, allowing for data flow between the threads in an orderly manner. If
+/// there is a bottleneck in the system (for instance, the writing thread only be
+/// able to write to disk at a fraction of the speed that frames are coming in),
+/// then some of these queues will fill up. They are all fixed-size lock-free
+/// rings, so once full they hold up the thread feeding them and the buffer pool
+/// shows stalls, rather than memory usage steadily climbing.
 class A3C {
-
-private:
+   private:
 
     AT_H   handle;
     string outputPath;
     int    frameLimit;
     int    imageSize;
+    int    poolSize;
+    int    queueDepth;
+    double diskBandwidth;
+    int    processThreads;
+    bool   nativeConversion;
+    string writerBackend;
+    string outputFormat;
+    string compression;
+    bool   trackBinning;
+    string correctedEncoding;
+    long   coaddFrames;
+    long   coaddStride;
+    long   streamInterval;
+    long   streamDepth;
+    bool   latencyTracking;
+    long   segmentFrames;
+    long   segmentBytes;
+    double segmentSeconds;
+    long   imageWidth;
+    long   imageHeight;
+    long   imageStride;
+    long   trackRows;
+    long   outputBytes;
+    long   clockFrequency;
+    double expectedDelta;
+    AT_64  lastTimestamp;
+
+    PixelEncoding encoding;
+    vector<long>  trackHeights;
+    Calibration   calibration;
+    Coadder       coadder;
+    FrameStream   stream;
+    A3CHeader     streamLayout;
+
+    /// @brief A processing worker, with its own queues in from the acquisition
+    /// thread and out to the reordering thread so that both stay single-producer,
+    /// single-consumer.
+    struct Worker {
+
+        thread            runner;
+        RingBuffer<Frame> input;
+        RingBuffer<Frame> output;
+        long              count       = 0;
+        long              lastCount   = 0;
+        long              fps         = 0;
+        long              rawBytes    = 0;
+        long              packedBytes = 0;
+        double            packSeconds = 0;
+
+    };
+
+    /// @brief One output file being written, along with its index. Unless output is
+    /// split into segments, there is only ever one of these, at outputPath.
+    struct Segment {
+
+        int                    number;
+        string                 path;
+        unique_ptr<Writer>     output;
+        unique_ptr<HDF5Output> hdf5;
+        ofstream               index;
+        vector<A3CIndexRecord> records;
+        A3CHeader              header;
+        long                   bytes          = sizeof(A3CHeader);
+        long                   firstSequence  = -1;
+        long                   lastSequence   = -1;
+        long long              firstTimestamp = 0;
+        long long              lastTimestamp  = 0;
+        bool                   failed         = false;
+
+        chrono::steady_clock::time_point opened = chrono::steady_clock::now();
+
+    };
 
     thread acquireThread;
-    thread processThread;
+    thread reorderThread;
     thread writeThread;
     thread monitorThread;
 
-    FIFOQueue<unsigned char *>  processQueue;
-    FIFOQueue<unsigned short *> writeQueue;
+    vector<unique_ptr<Worker>> workers;
+    RingBuffer<Frame>          writeQueue;
+
+    BufferPool             pool;
+    deque<unsigned char *> queued;
 
     vector<string> errors;
+    mutex          errorLock;
+
+    map<string, vector<double>> latencies;
 
     ostream* out          = &cout;
     bool     running      = false;
     bool     monitoring   = false;
+    bool     processing   = false;
     long     acquireCount = 0;
     long     processCount = 0;
     long     writeCount   = 0;
-
-public:
+    long     acquireFPS   = 0;
+    long     processFPS   = 0;
+    long     writeFPS     = 0;
+    long     reorderDepth = 0;
+    long     dropped      = 0;
+    long     late         = 0;
+    long     jumps        = 0;
+    long     writtenBytes = 0;
+    long     segmentCount = 0;
+    double   writeRate    = 0;
+    double   packRatio    = 0;
+    double   packRate     = 0;
+
+   public:
 
     A3C(const A3C& other) {
-        this->handle     = other.handle;
-        this->outputPath = other.outputPath;
-        this->frameLimit = other.frameLimit;
+        
+        this->handle        = other.handle;
+        this->outputPath    = other.outputPath;
+        this->frameLimit    = other.frameLimit;
+        this->poolSize      = other.poolSize;
+        this->queueDepth    = other.queueDepth;
+        this->diskBandwidth  = other.diskBandwidth;
+        this->processThreads   = other.processThreads;
+        this->nativeConversion = other.nativeConversion;
+        this->writerBackend    = other.writerBackend;
+        this->outputFormat     = other.outputFormat;
+        this->compression      = other.compression;
+        this->trackBinning     = other.trackBinning;
+        this->correctedEncoding = other.correctedEncoding;
+        this->coaddFrames      = other.coaddFrames;
+        this->coaddStride      = other.coaddStride;
+        this->streamInterval   = other.streamInterval;
+        this->streamDepth      = other.streamDepth;
+        this->latencyTracking  = other.latencyTracking;
+        this->calibration      = other.calibration;
+        this->segmentFrames    = other.segmentFrames;
+        this->segmentBytes     = other.segmentBytes;
+        this->segmentSeconds   = other.segmentSeconds;
+
     }
 
     A3C(AT_H handle) {
 
-        this->handle     = handle;
-        this->outputPath = "output.h5";
-        this->frameLimit = -1;
+        this->handle        = handle;
+        this->outputPath    = "output.h5";
+        this->frameLimit    = -1;
+        this->poolSize      = 128;
+        this->queueDepth    = 10;
+        this->diskBandwidth  = 0;
+        this->processThreads   = 2;
+        this->nativeConversion = true;
+        this->writerBackend    = "stream";
+        this->outputFormat     = "a3c";
+        this->compression      = "none";
+        this->trackBinning     = false;
+        this->correctedEncoding = "Mono16";
+        this->coaddFrames      = 1;
+        this->coaddStride      = 0;
+        this->streamInterval   = 0;
+        this->streamDepth      = 4;
+        this->latencyTracking  = false;
+        this->segmentFrames    = 0;
+        this->segmentBytes     = 0;
+        this->segmentSeconds   = 0;
 
         // Check that the camera is connected
         int result = AT_Flush(handle);
 
         if (result != AT_SUCCESS) {
-            throw result;
+            throw errorNames[result];
         }
         
     }
@@ -87,35 +244,449 @@ public:
         frameLimit = limit;
     }
 
-    void setOutputPath(string path) {
+    void setOutputPath(std::string path) {
         outputPath = path;
     }
 
+    void setPoolSize(int size) {
+        poolSize = size;
+    }
+
+    void setQueueDepth(int depth) {
+        queueDepth = depth > 0 ? depth : 1;
+    }
+
+    /// @brief Sets the sequential write bandwidth (in MB/s) of the output disk, so
+    /// that the monitor can report write throughput as a fraction of it. Zero
+    /// (the default) disables this.
+    void setDiskBandwidth(double mbPerSecond) {
+        diskBandwidth = mbPerSecond;
+    }
+
+    void setProcessThreads(int count) {
+        processThreads = count > 0 ? count : 1;
+    }
+
+    /// @brief Chooses between the built-in SIMD conversion engine (the default) and
+    /// the SDK's AT_ConvertBufferUsingMetadata() for turning raw frames into Mono16.
+    void setNativeConversion(bool flag) {
+        nativeConversion = flag;
+    }
+
+    /// @brief Chooses how frames are written to disk: "stream" (an ofstream, the
+    /// default), "pwrite", "uring" (asynchronous batched writes through io_uring,
+    /// falling back to pwrite if unavailable) or "direct" (block-aligned O_DIRECT
+    /// writes that bypass the page cache). Returns false, leaving the current
+    /// choice alone, if the backend isn't available on this platform.
+    bool setWriterBackend(std::string backend) {
+
+        for (string name : writerBackends()) {
+
+            if (name == backend) {
+                writerBackend = backend;
+                return true;
+            }
+
+        }
+
+        return false;
+
+    }
+
+    /// @brief Chooses what gets written: "a3c" (the default) for raw frames after an
+    /// A3CHeader, with an index file alongside, or "hdf5" for an HDF5 file holding
+    /// the frames along with their timestamps, sequence numbers and status flags.
+    /// Returns false, leaving the current choice alone, if the format isn't available.
+    bool setOutputFormat(std::string format) {
+
+        if (format == "a3c" || (format == "hdf5" && hdf5Available())) {
+            outputFormat = format;
+            return true;
+        }
+
+        return false;
+
+    }
+
+    std::string getOutputFormat() {
+        return outputFormat;
+    }
+
+    /// @brief Chooses whether frames are compressed before being written to an A3C
+    /// file: "none" (the default) or "deltapack" (see compress.cpp), which is done by
+    /// the processing threads so runs in parallel across frames. HDF5 output and
+    /// co-added frames are never compressed. Returns false, leaving the current choice
+    /// alone, if unknown.
+    bool setCompression(std::string scheme) {
+
+        if (!compressionSupported(scheme)) {
+            return false;
+        }
+
+        compression = scheme;
+
+        return true;
+
+    }
+
+    std::string getCompression() {
+        return compression;
+    }
+
+    bool isCompressing() {
+        return compression != "none" && outputFormat == "a3c" && !isCoadding();
+    }
+
+    /// @brief When the camera is using the Multitrack AOI layout, sums the rows of each
+    /// track into a spectrum as frames are processed, and writes only those (as one
+    /// row of 32-bit totals per track) rather than whole frames. Has no effect on the
+    /// Image layout.
+    void setTrackBinning(bool flag) {
+        trackBinning = flag;
+    }
+
+    bool isTrackBinning() {
+        return trackBinning;
+    }
+
+    bool isBinningTracks() {
+        return trackBinning && !trackHeights.empty();
+    }
+
+    /// @brief Number of tracks in the layout read at the last start() (0 if not Multitrack).
+    long getTrackCount() {
+        return trackHeights.size();
+    }
+
+    /// @brief Loads a master dark to subtract from every frame, averaging all the frames
+    /// in the given A3C file (so either a saved master or a run of darks will do).
+    void loadDark(std::string path) {
+
+        long width, height;
+        vector<float> frame = loadAverage(path, width, height);
+
+        checkIdle();
+        calibration.setDark(frame, width, height);
+
+    }
+
+    /// @brief Loads a master flat to divide every frame by, in the same way as loadDark().
+    void loadFlat(std::string path) {
+
+        long width, height;
+        vector<float> frame = loadAverage(path, width, height);
+
+        checkIdle();
+        calibration.setFlat(frame, width, height);
+
+    }
+
+    /// @brief Makes a master dark by capturing the given number of frames with the
+    /// camera as it is currently set up (so presumably with the shutter closed) and
+    /// averaging them. At most COADD_MAX_FRAMES frames can go into it.
+    void buildDark(int frames) {
+        checkIdle();
+        calibration.setDark(averageFrames(frames), getInt(handle, "AOIWidth"), getInt(handle, "AOIHeight"));
+    }
+
+    /// @brief Makes a master flat in the same way as buildDark().
+    void buildFlat(int frames) {
+        checkIdle();
+        calibration.setFlat(averageFrames(frames), getInt(handle, "AOIWidth"), getInt(handle, "AOIHeight"));
+    }
+
+    void saveDark(std::string path) {
+
+        if (!calibration.hasDark()) {
+            throw string("No dark to save");
+        }
+
+        saveFrame(path, calibration.getDark(), calibration.getWidth(), calibration.getHeight());
+
+    }
+
+    void saveFlat(std::string path) {
+
+        if (!calibration.hasFlat()) {
+            throw string("No flat to save");
+        }
+
+        saveFrame(path, calibration.getFlat(), calibration.getWidth(), calibration.getHeight());
+
+    }
+
+    void clearDark() {
+        checkIdle();
+        calibration.clearDark();
+    }
+
+    void clearFlat() {
+        checkIdle();
+        calibration.clearFlat();
+    }
+
+    bool hasDark() {
+        return calibration.hasDark();
+    }
+
+    bool hasFlat() {
+        return calibration.hasFlat();
+    }
+
+    bool isCorrecting() {
+        return !calibration.isEmpty();
+    }
+
+    /// @brief Chooses what dark/flat corrected frames are written as: "Mono16" (the
+    /// default), rounded and clamped to 0 - 65535, or "Float32". Frames are always
+    /// corrected to Mono16 when binning tracks. Returns false if neither.
+    bool setCorrectedEncoding(std::string name) {
+
+        if (name == "Mono16" || name == "Float32") {
+            correctedEncoding = name;
+            return true;
+        }
+
+        return false;
+
+    }
+
+    std::string getCorrectedEncoding() {
+        return correctedEncoding;
+    }
+
+    /// @brief Sums every this many consecutive frames in software, writing only the
+    /// sums (as 32-bit totals) so cutting write bandwidth by as much while still reading
+    /// out at the full rate. 1 (the default) turns this off, and it only applies to
+    /// Mono16 output (so not to binned tracks or Float32 corrected frames). A partial
+    /// sum left over when capturing stops is dropped.
+    void setCoaddFrames(long frames) {
+        coaddFrames = frames < 1 ? 1 : frames > COADD_MAX_FRAMES ? COADD_MAX_FRAMES : frames;
+    }
+
+    /// @brief How many frames apart each sum starts: 0 (the default) or anything not
+    /// less than the number of frames for sums that don't overlap, or less than that
+    /// for a sliding window (which has to hold on to that many frames in memory).
+    void setCoaddStride(long frames) {
+        coaddStride = frames > 0 ? frames : 0;
+    }
+
+    long getCoaddFrames() {
+        return coaddFrames;
+    }
+
+    long getCoaddStride() {
+        return coaddStride;
+    }
+
+    bool isCoadding() {
+        return coaddFrames > 1 && !isBinningTracks() && !(isCorrecting() && correctedEncoding == "Float32");
+    }
+
+    /// @brief Copies every this many frames written out to be picked up with nextFrame()
+    /// (0, the default, for none), e.g. for live analysis alongside the capture. Each
+    /// copy is of the frame as written, so a sum if co-adding, spectra if binning
+    /// tracks and so on, decompressed if need be.
+    void setStreamInterval(long frames) {
+        streamInterval = frames > 0 ? frames : 0;
+    }
+
+    /// @brief How many copied frames are kept for nextFrame() before the oldest is
+    /// dropped to make room, rather than holding up capturing.
+    void setStreamDepth(long frames) {
+        streamDepth = frames > 0 ? frames : 1;
+    }
+
+    long getStreamInterval() {
+        return streamInterval;
+    }
+
+    long getStreamDepth() {
+        return streamDepth;
+    }
+
+    /// @brief Waits up to timeout ms for the next copied frame. If none comes, or
+    /// capturing has stopped and every frame has been taken, the frame returned is
+    /// not valid.
+    StreamFrame nextFrame(long timeout) {
+        return stream.pop(timeout);
+    }
+
+    /// @brief Whether nextFrame() may still return frames: those not yet taken, or
+    /// more to come while capturing with a stream interval set.
+    bool isStreaming() {
+        return stream.isOpen();
+    }
+
+    /// @brief Copied frames dropped before nextFrame() took them, since capturing started.
+    long getStreamDropped() {
+        return stream.getDropped();
+    }
+
+    /// @brief Records how long each frame spends in each stage of the pipeline, for
+    /// getLatencies(). Off by default, as the samples take memory (up to
+    /// LATENCY_SAMPLE_LIMIT frames' worth).
+    void setLatencyTracking(bool flag) {
+        latencyTracking = flag;
+    }
+
+    bool isLatencyTracking() {
+        return latencyTracking;
+    }
+
+    /// @brief Latencies (in microseconds) recorded for the given stage during the last
+    /// capture, in the order the frames were written. The stages are "process" (from
+    /// the camera handing the frame over to it being processed, including waiting for
+    /// a worker), "reorder" (waiting to be put back in order, and co-added), "write"
+    /// (waiting for, and being handed to, the writer) and "total". Only call this once
+    /// capturing has stopped.
+    vector<double> getLatencies(std::string stage) {
+        return latencies[stage];
+    }
+
+    /// @brief Splits the output into segments of at most this many frames (0, the
+    /// default, for no limit). Any of the segment limits being set means the output
+    /// is split, with each segment numbered before the extension of the output path
+    /// and listed in a manifest next to it as soon as it is closed.
+    void setSegmentFrames(long frames) {
+        segmentFrames = frames > 0 ? frames : 0;
+    }
+
+    /// @brief Splits the output into segments of at most this many bytes (0 for no limit).
+    void setSegmentBytes(long bytes) {
+        segmentBytes = bytes > 0 ? bytes : 0;
+    }
+
+    /// @brief Splits the output into segments covering at most this many seconds (0 for no limit).
+    void setSegmentSeconds(double seconds) {
+        segmentSeconds = seconds > 0 ? seconds : 0;
+    }
+
+    long getSegmentFrames() {
+        return segmentFrames;
+    }
+
+    long getSegmentBytes() {
+        return segmentBytes;
+    }
+
+    double getSegmentSeconds() {
+        return segmentSeconds;
+    }
+
+    bool isSegmented() {
+        return segmentFrames > 0 || segmentBytes > 0 || segmentSeconds > 0;
+    }
+
     int getFrameLimit() {
         return frameLimit;
     }
 
-    string getOutputPath() {
+    int getPoolSize() {
+        return poolSize;
+    }
+
+    int getQueueDepth() {
+        return queueDepth;
+    }
+
+    int getProcessThreads() {
+        return processThreads;
+    }
+
+    bool isNativeConversion() {
+        return nativeConversion;
+    }
+
+    std::string getConversionKernel() {
+        return ::getConversionKernel();
+    }
+
+    std::string getWriterBackend() {
+        return writerBackend;
+    }
+
+    std::string getOutputPath() {
         return outputPath;
     }
 
     void start() {
 
-        // Set both flags to true so that loops do the looping
+        // Tell the camera to include metadata and to continuously capture, before
+        // asking for the buffer size since the metadata makes each frame bigger
+        setBool(handle, "MetadataEnable", true);
+        setBool(handle, "MetadataFrameInfo", true);
+        setBool(handle, "MetadataTimestamp", true);
+        setEnum(handle, "CycleMode", "Continuous");
+
+        // Query camera for buffer size and allocate all acquisition buffers up-front,
+        // making sure there are always more than are kept queued on the camera
+        int buffers = poolSize > queueDepth ? poolSize : queueDepth + 1;
+        imageSize   = getInt(handle, "ImageSizeBytes");
+        pool.allocate(buffers, imageSize);
+
+        // Needed to turn metadata timestamps into seconds, and to know how far apart they should be
+        clockFrequency = getInt(handle, "TimestampClockFrequency");
+        expectedDelta  = clockFrequency / getFloat(handle, "FrameRate");
+        dropped        = 0;
+        late           = 0;
+        jumps          = 0;
+        packRatio      = 0;
+        packRate       = 0;
+
+        // Layout of the raw frames, which can't change while acquiring
+        imageWidth  = getInt(handle, "AOIWidth");
+        imageHeight = getInt(handle, "AOIHeight");
+        imageStride = getInt(handle, "AOIStride");
+        encoding    = encodingFromString(getEnum(handle, "PixelEncoding"));
+
+        readTracks();
+
+        // The dark and flat are turned into an offset and gain once, here, so they can be
+        // swapped for others between runs
+        if (isCorrecting()) {
+            calibration.prepare(imageWidth, imageHeight);
+        }
+
+        streamLayout = outputLayout();
+        outputBytes  = streamLayout.frameBytes();
+
+        coadder.reset(coaddFrames, coaddStride, imageWidth * imageHeight);
+        stream.start(streamInterval, streamDepth);
+        latencies.clear();
+
+        // Size and clear all queues, with room for every pooled buffer plus the
+        // end-of-stream frames pushed by stop()
+        writeQueue.resize(buffers + 1);
+        workers.clear();
+
+        for (int i = 0; i < processThreads; i++) {
+            workers.push_back(make_unique<Worker>());
+            workers[i]->input.resize(buffers + 1);
+            workers[i]->output.resize(buffers + 1);
+        }
+
+        // Only now that nothing above can have thrown, set all flags to true so that
+        // loops do the looping
         running    = true;
         monitoring = true;
-
-        // Clear both queues
-        processQueue.clear();
-        writeQueue.clear();
+        processing = true;
 
         // Set all threads running
         *out << "Starting writing thread... ";
         writeThread = thread(&A3C::write, this);
         *out << "Done." << endl;
 
-        *out << "Starting processing thread... ";
-        processThread = thread(&A3C::process, this);
+        *out << "Starting reordering thread... ";
+        reorderThread = thread(&A3C::reorder, this);
+        *out << "Done." << endl;
+
+        *out << "Starting " << processThreads << " processing threads... ";
+
+        for (auto &worker : workers) {
+            worker->runner = thread(&A3C::process, this, worker.get());
+        }
+
         *out << "Done." << endl;
 
         *out << "Starting acquisition thread... ";
@@ -130,19 +701,34 @@ public:
 
     void stop() {
 
+        // Nothing was started, if start() never got as far as starting the threads
+        if (!monitoring) {
+            return;
+        }
+
         // Indicate to all threads that we wish to stop
         running = false;
 
         // Wait for the acquisition thread to stop
         acquireThread.join();
 
-        // Push a null pointer to the processing queue, in case it is currently
-        // blocking then wait for it to finish
-        processQueue.push(nullptr);
-        processThread.join();
+        // Push an end-of-stream frame to each processing worker, so that each one
+        // stops once it has worked through everything before it
+        for (auto &worker : workers) {
+            worker->input.push(Frame());
+        }
+
+        for (auto &worker : workers) {
+            worker->runner.join();
+        }
+
+        // Once the workers are done, the reordering thread only has to drain what's left
+        processing = false;
+        reorderThread.join();
+        stream.stop();
 
         // Same for writing queue
-        writeQueue.push(nullptr);
+        writeQueue.push(Frame());
         writeThread.join();
 
         // Tell the monitoring thread to stop and wait for it to do so
@@ -151,155 +737,920 @@ public:
 
     }
 
-    int acquire() {
+    /// @brief Reads the track layout, if the camera is in the Multitrack AOI layout,
+    /// where each frame is made up of the rows of each track in turn (just the one
+    /// for a track the camera bins itself).
+    void readTracks() {
 
-        // Declare variables
-        unsigned char* pBuffer;
-        int            size = 0;
-        long           start = time(0);
-        double         temperature;
+        trackHeights.clear();
+        trackRows = 0;
 
-        // Calculate timeout to use for acquisitions in ms (min 500 ms)
-        float  frameRate  = getFloat(handle, "FrameRate");
-        float  frameTime  = 1.0 / frameRate;
-        long   time       = (long) (1000.0 * 2.0 * frameTime);
-        long   timeOut    = time > 500 ? time : 500;
+        AT_BOOL implemented = false;
+        AT_IsImplemented(handle, L"MultitrackCount", &implemented);
 
-        // Tell the camera to include metadata and to continuously capture
-        setBool(handle, "MetadataEnable", true);
-        setBool(handle, "MetadataFrameInfo", true);
-        setBool(handle, "MetadataTimestamp", true);
-        setBool(handle, "MetadataEnable", true);
-        setEnum(handle, "CycleMode", "Continuous");
+        if (!implemented || getEnum(handle, "AOILayout") != "Multitrack") {
+            return;
+        }
 
-        // Query camera for buffer size
-        imageSize = getInt(handle, "ImageSizeBytes");
+        long count = getInt(handle, "MultitrackCount");
+        long rows  = 0;
 
-        // Start the acquisition
-        AT_Command(handle, L"AcquisitionStart");
+        for (long i = 0; i < count; i++) {
 
-        for (acquireCount = 0; running; acquireCount++) {
+            setInt(handle, "MultitrackSelector", i);
 
-            // Create new buffer, queue it and await data
-            unsigned char *buffer = new unsigned char[imageSize];
-            int            qCode  = AT_QueueBuffer(handle, buffer, imageSize);
-            int            wCode  = AT_WaitBuffer(handle, &pBuffer, &size, timeOut);
+            long height = getBool(handle, "MultitrackBinned") ? 1 : getInt(handle, "MultitrackEnd") - getInt(handle, "MultitrackStart") + 1;
 
-            // If there was an error, record it and restart acquisition
-            if (qCode != AT_SUCCESS || wCode != AT_SUCCESS) {
+            trackHeights.push_back(height);
+            rows += height;
 
-                if (wCode == 13) {
-                    errors.push_back("Acquisition Time-Out (" + to_string(qCode) + ", " + to_string(wCode) + "), restarting acquisition.");
-                } else {
-                    errors.push_back("Error (" + to_string(qCode) + ", " + to_string(wCode) + "), restarting acquisition.");
-                }
+        }
 
-                AT_Command(handle, L"AcquisitionStop");
-                AT_Flush(handle);
-                AT_Command(handle, L"AcquisitionStart");
+        // Shouldn't happen, but better not to split frames up at all than to split them wrongly
+        if (rows != imageHeight) {
+            report("Track layout doesn't add up to AOIHeight, so tracks won't be binned");
+            trackHeights.clear();
+            return;
+        }
 
-                continue;
+        // Tracks all the same size can each be their own chunk in HDF5 output
+        trackRows = trackHeights[0];
+
+        for (long height : trackHeights) {
 
+            if (height != trackRows) {
+                trackRows = 0;
             }
 
-            // Push the buffer into the processing queue
-            processQueue.push(pBuffer);
+        }
+
+    }
+
+    /// @brief Layout of what gets written for each frame: the Mono16 image as captured,
+    /// one row of 32-bit totals per track if binning tracks, Float32 if asked for when
+    /// correcting frames, or 32-bit totals if co-adding.
+    A3CHeader outputLayout() {
 
+        if (isBinningTracks()) {
+            return A3CHeader(imageWidth, trackHeights.size(), "Mono32");
         }
 
-        // Stop acquisition and flush through any remaining buffers
-        AT_Command(handle, L"AcquisitionStop");
-        AT_Flush(handle);
+        if (isCorrecting() && correctedEncoding == "Float32") {
+            return A3CHeader(imageWidth, imageHeight, "Float32");
+        }
 
-        return 0;
+        if (isCoadding()) {
+            return A3CHeader(imageWidth, imageHeight, "Mono32");
+        }
+
+        return A3CHeader(imageWidth, imageHeight, "Mono16");
 
     }
 
-    int process() {
+    void checkIdle() {
 
-        // Keep going so long as we're runnning, or there's still frames to process in the queue
-        for (processCount = 0; running || processQueue.hasWaiting(); processCount++) {
+        if (running) {
+            throw string("Can't change the dark or flat while capturing");
+        }
 
-            // Get next frame in queue, if none present then this blocks (waits) until there is one
-            unsigned char *buffer = processQueue.pop();
+    }
 
-            // If we've been given a nullt pointer, ignore it
-            if (buffer == nullptr) {
-                continue;
-            }
+    /// @brief Captures the given number of frames outside of the pipeline, converting
+    /// each to Mono16 and summing them, then returns their average. The camera's cycle
+    /// mode and frame count are put back as they were afterwards.
+    vector<float> averageFrames(int frames) {
 
-            // Extract timestamp and image size from meta data
-            AT_64 timestamp;
-            AT_64 imageHeight;
-            AT_64 imageWidth;
-            AT_GetTimeStampFromMetadata(buffer, imageSize, timestamp);
-            AT_GetWidthFromMetadata(buffer, imageSize, imageWidth);
-            AT_GetHeightFromMetadata(buffer, imageSize, imageHeight);
+        if (frames < 1) {
+            throw string("Need at least one frame to average");
+        }
 
-            int size = imageWidth * imageHeight;
+        // Any more and the 32-bit totals could overflow
+        if (frames > COADD_MAX_FRAMES) {
+            throw "Can't average more than " + to_string(COADD_MAX_FRAMES) + " frames";
+        }
 
-            // Create buffer for processed image
-            unsigned short *converted = new unsigned short[size];
+        long          width    = getInt(handle, "AOIWidth");
+        long          height   = getInt(handle, "AOIHeight");
+        long          stride   = getInt(handle, "AOIStride");
+        long          size     = getInt(handle, "ImageSizeBytes");
+        PixelEncoding encoding = encodingFromString(getEnum(handle, "PixelEncoding"));
+        long          pixels   = width * height;
+        int           depth    = frames < queueDepth ? frames : queueDepth;
 
-            // Convert image into an array of shorts (i.e., 16-bit integers) without padding etc
-            AT_ConvertBufferUsingMetadata(buffer, (unsigned char *)converted, imageSize, L"Mono16");
+        // Same timeout as when capturing: two frames' worth, but at least 500 ms
+        long time    = (long) (1000.0 * 2.0 / getFloat(handle, "FrameRate"));
+        long timeOut = time > 500 ? time : 500;
 
-            // Push to the converted image back of the write queue
-            writeQueue.push(converted);
+        BufferPool       buffers;
+        vector<uint16_t> converted(pixels);
+        vector<uint32_t> sum(pixels, 0);
 
-            // Free the original image's memory
-            delete[] buffer;
-        }
+        buffers.allocate(depth, size);
 
-        return 0;
+        CycleGuard cycle(handle);
 
-    }
+        setEnum(handle, "CycleMode", "Fixed");
+        setInt(handle, "FrameCount", frames);
 
-    int write() {
+        for (int i = 0; i < depth; i++) {
+            AT_QueueBuffer(handle, buffers.tryAcquire(), size);
+        }
 
-        remove(outputPath.c_str());
+        AT_Command(handle, L"AcquisitionStart");
 
-        ofstream output = ofstream(outputPath, ios::binary | ios::out);
+        int result = AT_SUCCESS;
 
-        long imageHeight = getInt(handle, "AOIHeight");
-        long imageWidth  = getInt(handle, "AOIWidth");
-        long size        = imageHeight * imageWidth;
+        for (int i = 0; i < frames && result == AT_SUCCESS; i++) {
 
-        for (writeCount = 0; running || writeQueue.hasWaiting(); writeCount++) {
+            unsigned char* buffer;
+            int            length;
 
-            unsigned short *buffer = writeQueue.pop();
+            result = AT_WaitBuffer(handle, &buffer, &length, timeOut);
 
-            if (buffer == nullptr) {
-                continue;
+            if (result != AT_SUCCESS) {
+                break;
             }
 
-            for (int i = 0; i < size; i++) {
-                output << buffer[i];
+            if (!convertToMono16(buffer, converted.data(), width, height, stride, encoding, length)) {
+                result = AT_ERR_NOTIMPLEMENTED;
+                break;
             }
 
-            delete[] buffer;
+            // Totals can't overflow, as there are at most COADD_MAX_FRAMES frames
+            activeKernels().accumulate16(converted.data(), sum.data(), pixels);
 
-        }
+            if (i + depth < frames) {
+                AT_QueueBuffer(handle, buffer, size);
+            }
 
-        *out << endl;
+        }
 
-        output.close();
+        AT_Command(handle, L"AcquisitionStop");
+        AT_Flush(handle);
 
-        return 0;
-    }
+        if (result != AT_SUCCESS) {
+            throw "Capturing calibration frames: " + errorNames[result] + " (" + to_string(result) + ")";
+        }
 
-    int monitor() {
+        vector<float> average(pixels);
 
-        long last = time(0);
-        long lastAcquireCount = 0;
-        long lastProcessCount = 0;
-        long lastWriteCount   = 0;
+        for (long i = 0; i < pixels; i++) {
+            average[i] = (float) sum[i] / frames;
+        }
 
-        this_thread::sleep_for(chrono::seconds(1));
+        return average;
 
-        *out << "...";
+    }
 
-        while (monitoring) {
+    int acquire() {
+
+        // Declare variables
+        unsigned char* pBuffer;
+        int            size     = 0;
+        long           sequence = 0;
+        long           start = time(0);
+        double         temperature;
+
+        // Calculate timeout to use for acquisitions in ms (min 500 ms)
+        float  frameRate  = getFloat(handle, "FrameRate");
+        float  frameTime  = 1.0 / frameRate;
+        long   time       = (long) (1000.0 * 2.0 * frameTime);
+        long   timeOut    = time > 500 ? time : 500;
+
+        // Queue up the initial set of buffers so the camera has somewhere to put
+        // frames as soon as it starts, then start the acquisition
+        fillQueue(timeOut);
+        AT_Command(handle, L"AcquisitionStart");
+
+        for (acquireCount = 0; running && (frameLimit <= 0 || acquireCount < frameLimit); acquireCount++) {
+
+            // If the camera has nothing queued (i.e., the pool was exhausted), then wait
+            // for the rest of the pipeline to hand a buffer back before going any further
+            if (queued.empty()) {
+
+                fillQueue(timeOut);
+
+                if (queued.empty()) {
+                    acquireCount--;
+                    continue;
+                }
+
+            }
+
+            // Await data in the oldest queued buffer
+            int wCode = AT_WaitBuffer(handle, &pBuffer, &size, timeOut);
+
+            // If there was an error, record it and restart acquisition
+            if (wCode != AT_SUCCESS) {
+
+                if (wCode == AT_ERR_TIMEDOUT) {
+                    report("Acquisition Time-Out (" + to_string(wCode) + "), restarting acquisition.");
+                } else {
+                    report("Error (" + to_string(wCode) + "), restarting acquisition.");
+                }
+
+                AT_Command(handle, L"AcquisitionStop");
+                AT_Flush(handle);
+
+                // Flushing means the camera no longer holds any buffers, so they can all go back into the pool
+                releaseQueue();
+                fillQueue(timeOut);
+
+                AT_Command(handle, L"AcquisitionStart");
+
+                acquireCount--;
+                continue;
+
+            }
+
+            // Buffers are returned in the order they were queued
+            queued.pop_front();
+
+            // Push the buffer into the processing queue, then immediately replace it on the camera
+            dispatch(sequence++, pBuffer);
+            fillQueue(timeOut);
+
+        }
+
+        running = false;
+
+        // Stop acquisition and flush through any remaining buffers
+        AT_Command(handle, L"AcquisitionStop");
+        AT_Flush(handle);
+        releaseQueue();
+
+        return 0;
+
+    }
+
+    /// @brief Tops up the buffers queued on the camera to queueDepth. It only waits
+    /// on the pool if the camera has nothing left to write into at all.
+    void fillQueue(long timeOut) {
+
+        while ((int) queued.size() < queueDepth) {
+
+            unsigned char *buffer = queued.empty() ? pool.acquire(timeOut) : pool.tryAcquire();
+
+            if (buffer == nullptr) {
+                return;
+            }
+
+            int result = AT_QueueBuffer(handle, buffer, imageSize);
+
+            if (result != AT_SUCCESS) {
+                report("Error queuing buffer (" + to_string(result) + ").");
+                pool.release(buffer);
+                return;
+            }
+
+            queued.push_back(buffer);
+
+        }
+
+    }
+
+    /// @brief Returns every buffer queued on the camera to the pool. Only call this
+    /// after AT_Flush(), once the SDK has let go of them.
+    void releaseQueue() {
+
+        for (unsigned char *buffer : queued) {
+            pool.release(buffer);
+        }
+
+        queued.clear();
+
+    }
+
+    /// @brief Hands a captured buffer to the processing worker with the least
+    /// waiting for it, starting from the next one in turn.
+    void dispatch(long sequence, unsigned char *buffer) {
+
+        Frame frame;
+        frame.sequence = sequence;
+        frame.raw      = buffer;
+        frame.acquired = chrono::steady_clock::now();
+
+        Worker *target = workers[sequence % workers.size()].get();
+
+        for (auto &worker : workers) {
+
+            if (worker->input.size() < target->input.size()) {
+                target = worker.get();
+            }
+
+        }
+
+        target->input.push(frame);
+
+    }
+
+    int process(Worker *worker) {
+
+        for (worker->count = 0; ; worker->count++) {
+
+            // Get next frame in queue, if none present then this blocks (waits) until there is one
+            Frame frame = worker->input.pop();
+
+            // If we've reached the end of the stream, stop
+            if (frame.isEnd()) {
+                break;
+            }
+
+            unsigned char *buffer   = frame.raw;
+            FrameMetadata &metadata = frame.metadata;
+
+            // Extract timestamp and image layout from meta data in a single pass, if the
+            // frame info is somehow missing then fall back on what the camera told us
+            if (!parseMetadata(buffer, imageSize, metadata)) {
+                metadata      = FrameMetadata();
+                frame.status |= FRAME_NO_METADATA;
+            }
+
+            if (!metadata.hasTimestamp) {
+                frame.status |= FRAME_NO_TIMESTAMP;
+            }
+
+            // The layout can't change while acquiring, so frame info that disagrees with the
+            // AOI (or wouldn't fit the buffer) is corrupt, and everything downstream is sized
+            // for the AOI anyway
+            bool badLayout = metadata.hasFrameInfo && (
+                metadata.width    != imageWidth  ||
+                metadata.height   != imageHeight ||
+                metadata.stride   != imageStride ||
+                metadata.encoding != encoding    ||
+                metadata.stride * metadata.height > imageSize
+            );
+
+            if (badLayout) {
+                frame.status |= FRAME_BAD_LAYOUT;
+            }
+
+            if (!metadata.hasFrameInfo || badLayout) {
+                metadata.width    = imageWidth;
+                metadata.height   = imageHeight;
+                metadata.stride   = imageStride;
+                metadata.encoding = encoding;
+            }
+
+            int size = metadata.width * metadata.height;
+
+            // Create buffer for processed image
+            unsigned short *converted = new unsigned short[size];
+
+            // Convert image into an array of shorts (i.e., 16-bit integers) without padding etc,
+            // falling back to the SDK for anything the native engine doesn't handle (told the AOI
+            // layout outright when the metadata can't be trusted with it)
+            bool converted16 = nativeConversion && convertToMono16(buffer, converted, metadata.width, metadata.height, metadata.stride, metadata.encoding, imageSize);
+
+            if (!converted16) {
+
+                int result = badLayout
+                    ? AT_ConvertBuffer(buffer, (unsigned char *)converted, imageWidth, imageHeight, imageStride, internWC(encodingName(encoding)), L"Mono16")
+                    : AT_ConvertBufferUsingMetadata(buffer, (unsigned char *)converted, imageSize, L"Mono16");
+
+                if (result != AT_SUCCESS) {
+                    frame.status |= FRAME_CONVERSION_FAILED;
+                }
+
+            }
+
+            // Subtract the dark and divide by the flat, either in place or into a new Float32 frame
+            // (allocated the same way as converted images, so that the writer can free either)
+            if (isCorrecting() && (long) calibration.offset.size() == size) {
+
+                if (correctedEncoding == "Float32" && !isBinningTracks()) {
+
+                    unsigned short* corrected = new unsigned short[2 * size];
+
+                    activeKernels().correctFloat(converted, calibration.offset.data(), calibration.gain.data(), corrected, size);
+
+                    delete[] converted;
+                    converted = corrected;
+
+                } else {
+                    activeKernels().correct16(converted, calibration.offset.data(), calibration.gain.data(), converted, size);
+                }
+
+            }
+
+            // Reduce each track to a spectrum by summing its rows, so only those need writing.
+            // The totals are allocated the same way as converted images so the writer can free either.
+            if (isBinningTracks()) {
+
+                unsigned short*       spectra = new unsigned short[2 * trackHeights.size() * metadata.width];
+                const unsigned short* track   = converted;
+
+                for (size_t i = 0; i < trackHeights.size(); i++) {
+                    sumRows(track, (uint32_t*) spectra + i * metadata.width, metadata.width, trackHeights[i]);
+                    track += trackHeights[i] * metadata.width;
+                }
+
+                delete[] converted;
+                converted = spectra;
+
+            }
+
+            frame.data = converted;
+            frame.raw  = nullptr;
+
+            // Compressing here, rather than in the writing thread, means it's spread over all workers.
+            // Whatever is being written is compressed as 16-bit words, which for 32-bit totals isn't
+            // as effective but is still lossless.
+            if (isCompressing()) {
+
+                auto start = chrono::steady_clock::now();
+                long words = outputBytes / 2;
+
+                frame.packed      = (unsigned char*) new unsigned short[(deltapackBound(words) + 1) / 2];
+                frame.packedBytes = deltapackCompress(converted, words, frame.packed);
+                frame.data        = nullptr;
+
+                delete[] converted;
+
+                worker->rawBytes    += outputBytes;
+                worker->packedBytes += frame.packedBytes;
+                worker->packSeconds += chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+            }
+
+            // Pass the converted image on to be put back in order
+            frame.processed = chrono::steady_clock::now();
+            worker->output.push(frame);
+
+            // Hand the original image's buffer back to the pool for re-use
+            pool.release(buffer);
+
+        }
+
+        return 0;
+
+    }
+
+    /// @brief Collects frames from all processing workers and passes them on to the
+    /// write queue in the order they were acquired. Frames that arrive early wait in
+    /// a window indexed by sequence number (with anything too far ahead to fit
+    /// spilling into an overflow map) until everything before them has arrived.
+    int reorder() {
+
+        vector<Frame>    window(pool.capacity());
+        map<long, Frame> overflow;
+        long             next    = 0;
+
+        lastTimestamp = -1;
+        long             waiting = 0;
+        int              idle    = 0;
+
+        for (processCount = 0; processing || waiting > 0 || hasProcessWaiting(); ) {
+
+            bool received = false;
+
+            for (auto &worker : workers) {
+
+                Frame frame;
+
+                while (worker->output.tryPop(frame)) {
+
+                    received = true;
+
+                    if (frame.isEnd()) {
+                        continue;
+                    }
+
+                    if (frame.sequence - next < (long) window.size()) {
+                        window[frame.sequence % window.size()] = frame;
+                    } else {
+                        overflow[frame.sequence] = frame;
+                    }
+
+                    waiting++;
+
+                }
+
+            }
+
+            // Release everything that is now in order
+            while (true) {
+
+                Frame &slot = window[next % window.size()];
+
+                if (slot.sequence != next) {
+
+                    auto found = overflow.find(next);
+
+                    if (found == overflow.end()) {
+                        break;
+                    }
+
+                    slot = found->second;
+                    overflow.erase(found);
+
+                }
+
+                checkTiming(slot);
+
+                // Co-adding has to be done here, as it's the first point frames are back in order
+                if (isCoadding()) {
+
+                    Frame sum;
+
+                    if (coadder.add(slot, sum)) {
+                        forward(sum);
+                    }
+
+                } else {
+                    forward(slot);
+                }
+
+                slot = Frame();
+
+                next++;
+                waiting--;
+                processCount++;
+
+            }
+
+            reorderDepth = waiting;
+
+            // Back off if the workers have nothing for us
+            if (received) {
+                idle = 0;
+            } else if (idle++ < RING_SPIN_COUNT) {
+                this_thread::yield();
+            } else {
+                this_thread::sleep_for(chrono::microseconds(50));
+            }
+
+        }
+
+        reorderDepth = 0;
+
+        coadder.clear();
+
+        return 0;
+
+    }
+
+    /// @brief Passes a frame on to be written, first copying it out to the stream if
+    /// it's due a frame.
+    void forward(Frame &frame) {
+
+        if (stream.isDue()) {
+            stream.push(StreamFrame(frame, streamLayout, clockFrequency));
+        }
+
+        frame.ordered = chrono::steady_clock::now();
+        writeQueue.push(frame);
+
+    }
+
+    /// @brief Compares each frame's hardware timestamp against the previous one, in
+    /// capture order, to spot frames the camera never delivered. A gap of about n
+    /// frame periods means n - 1 frames were dropped, a gap that is long but less
+    /// than one and a half periods is counted as late, and a timestamp going
+    /// backwards (e.g., the clock being reset) is counted as a discontinuity.
+    void checkTiming(Frame &frame) {
+
+        if (!frame.metadata.hasTimestamp || expectedDelta <= 0) {
+            return;
+        }
+
+        AT_64 timestamp = frame.metadata.timestamp;
+
+        if (lastTimestamp >= 0) {
+
+            double periods = (timestamp - lastTimestamp) / expectedDelta;
+
+            if (periods <= 0) {
+
+                frame.status |= FRAME_DISCONTINUITY;
+                jumps++;
+
+            } else if (periods >= 1.5) {
+
+                frame.status |= FRAME_GAP;
+                dropped += (long) (periods + 0.5) - 1;
+
+            } else if (periods > 1.0 + TIMING_TOLERANCE) {
+
+                frame.status |= FRAME_LATE;
+                late++;
+
+            }
+
+        }
+
+        lastTimestamp = timestamp;
+
+    }
+
+    bool hasProcessWaiting() {
+
+        for (auto &worker : workers) {
+
+            if (worker->output.hasWaiting()) {
+                return true;
+            }
+
+        }
+
+        return false;
+
+    }
+
+    void report(string error) {
+        lock_guard<mutex> guard(errorLock);
+        errors.push_back(error);
+    }
+
+    /// @brief Opens a new output file (and its index) and writes placeholder headers.
+    Segment* openSegment(int number, long frameBytes) {
+
+        Segment* segment = new Segment();
+
+        segment->number = number;
+        segment->path   = isSegmented() ? segmentPath(outputPath, number) : outputPath;
+        segment->header = outputLayout();
+        segmentCount    = number + 1;
+
+        segment->header.compression = isCompressing() ? A3C_COMPRESSION_DELTAPACK : A3C_COMPRESSION_NONE;
+
+        // HDF5 files carry their own timestamps etc., so need no index or header
+        if (outputFormat == "hdf5") {
+
+            segment->hdf5.reset(new HDF5Output());
+
+            A3CHeader& layout = segment->header;
+
+            if (!segment->hdf5->open(segment->path, layout.width, layout.height, isBinningTracks() ? 0 : trackRows, clockFrequency, layout.encoding)) {
+                report("Write Error: " + segment->hdf5->getError());
+            }
+
+            return segment;
+
+        }
+
+        string indexPath = segment->path + A3C_INDEX_EXTENSION;
+
+        remove(segment->path.c_str());
+        remove(indexPath.c_str());
+
+        // Converted frames are handed back by the writer once it is done with them,
+        // which for an asynchronous backend can be a while after they were passed to it
+        segment->output.reset(createWriter(writerBackend, [](unsigned char* buffer) {
+            delete[] (unsigned short*) buffer;
+        }));
+
+        segment->index = ofstream(indexPath, ios::binary | ios::out);
+
+        if (!segment->output->open(segment->path, sizeof(A3CHeader))) {
+            report("Write Error: " + segment->output->getError());
+        }
+
+        // Index records are collected and appended in batches, rather than one small write per frame
+        segment->records.reserve(INDEX_BATCH_SIZE);
+
+        A3CIndexHeader(clockFrequency).write(segment->index);
+
+        // Write a placeholder header now, then fill in the frame count once we're done
+        segment->output->writeAt(&segment->header, sizeof(A3CHeader), 0);
+
+        // If the final size is known (from the frame limit or segment size), reserve all of it
+        // now, otherwise reserve a chunk at a time as we go (the rest is released on close)
+        long frames   = segmentFrames > 0 ? segmentFrames : frameLimit;
+        long expected = frames > 0 ? sizeof(A3CHeader) + frames * frameBytes : 0;
+
+        if (segmentBytes > 0 && (expected == 0 || segmentBytes < expected)) {
+            expected = segmentBytes;
+        }
+
+        segment->output->preallocate(expected, PREALLOCATE_CHUNK_BYTES);
+
+        return segment;
+
+    }
+
+    /// @brief Whether a segment is full, given the next frame to go into it.
+    bool segmentDue(Segment* segment, long frameBytes) {
+
+        if (segment->header.frameCount == 0) {
+            return false;
+        }
+
+        double age = chrono::duration<double>(chrono::steady_clock::now() - segment->opened).count();
+
+        return (segmentFrames  > 0 && (long) segment->header.frameCount >= segmentFrames)
+            || (segmentBytes   > 0 && segment->bytes + frameBytes > segmentBytes)
+            || (segmentSeconds > 0 && age >= segmentSeconds);
+
+    }
+
+    /// @brief Finishes off a segment: waits for its data to reach the disk, fills in the
+    /// real frame count and closes it, then lists it in the manifest (if there is one).
+    void closeSegment(Segment* segment, ofstream& manifest) {
+
+        if (segment->hdf5) {
+
+            if (!segment->hdf5->close() && !segment->failed) {
+                report("Write Error: " + segment->hdf5->getError());
+            }
+
+            error_code problem;
+            segment->bytes = (long) filesystem::file_size(segment->path, problem);
+
+        } else {
+
+            segment->index.write((const char*) segment->records.data(), segment->records.size() * sizeof(A3CIndexRecord));
+            segment->index.close();
+
+            if (!segment->output->flush() && !segment->failed) {
+                report("Write Error: " + segment->output->getError());
+            }
+
+            segment->output->writeAt(&segment->header, sizeof(A3CHeader), 0);
+            segment->output->close();
+
+        }
+
+        if (manifest.is_open()) {
+
+            string name = segment->path.substr(segment->path.find_last_of("/\\") + 1);
+
+            manifest << segment->number << '\t' << name << '\t' << segment->firstSequence << '\t' << segment->lastSequence
+                     << '\t' << segment->header.frameCount << '\t' << segment->bytes << '\t' << segment->firstTimestamp
+                     << '\t' << segment->lastTimestamp << endl;
+
+        }
+
+    }
+
+    int write() {
+
+        long frameBytes = outputBytes;
+
+        string   manifestPath = outputPath + A3C_MANIFEST_EXTENSION;
+        ofstream manifest;
+
+        remove(manifestPath.c_str());
+
+        if (isSegmented()) {
+            manifest.open(manifestPath, ios::out);
+            manifest << "# A3C manifest v" << A3C_MANIFEST_VERSION << endl;
+            manifest << "# segment\tpath\tfirstSequence\tlastSequence\tframes\tbytes\tfirstTimestamp\tlastTimestamp" << endl;
+        }
+
+        // Full segments are finished off on a thread of their own, so that waiting for
+        // their last writes doesn't hold up the frames going into the next one
+        FIFOQueue<Segment*> closing;
+
+        thread closer = thread([&]() {
+
+            for (Segment* segment = closing.pop(); segment != nullptr; segment = closing.pop()) {
+                closeSegment(segment, manifest);
+                delete segment;
+            }
+
+        });
+
+        // Except for HDF5 files: the library usually isn't built thread-safe, so every call
+        // into it has to come from this thread, and the closer then never touches the manifest
+        auto retire = [&](Segment* finished) {
+
+            if (finished->hdf5) {
+                closeSegment(finished, manifest);
+                delete finished;
+            } else {
+                closing.push(finished);
+            }
+
+        };
+
+        unique_ptr<Segment> segment(openSegment(0, frameBytes));
+
+        if (segment->output && segment->output->getName() != writerBackend) {
+            *out << "Writer \"" << writerBackend << "\" unavailable, using \"" << segment->output->getName() << "\" instead." << endl;
+        }
+
+        writtenBytes = sizeof(A3CHeader);
+
+        for (writeCount = 0; ; writeCount++) {
+
+            // Keep going until we're given the end-of-stream frame from stop()
+            Frame frame = writeQueue.pop();
+
+            if (frame.isEnd()) {
+                break;
+            }
+
+            // Compressed frames each take up a different number of bytes
+            unsigned char* data  = frame.packed ? frame.packed : (unsigned char*) frame.data;
+            long           bytes = frame.packed ? frame.packedBytes : frameBytes;
+
+            if (segmentDue(segment.get(), bytes)) {
+                retire(segment.release());
+                segment.reset(openSegment(segmentCount, frameBytes));
+                writtenBytes += sizeof(A3CHeader);
+            }
+
+            if (segment->hdf5) {
+
+                // Frame goes in as the next entry of each dataset
+                if (!segment->hdf5->write(frame.data, frame.sequence, frame.metadata.timestamp, frame.status) && !segment->failed) {
+                    report("Write Error: " + segment->hdf5->getError());
+                    segment->failed = true;
+                }
+
+                delete[] frame.data;
+
+            } else {
+
+                // Each frame goes to disk as one contiguous block of raw 16-bit pixels (or its compressed
+                // equivalent), only reporting the first failure rather than one for every frame after it
+                if (!segment->output->write(data, bytes) && !segment->failed) {
+                    report("Write Error: " + segment->output->getError());
+                    segment->failed = true;
+                }
+
+                segment->records.push_back({
+                    (uint64_t) frame.sequence,
+                    (uint64_t) frame.metadata.timestamp,
+                    (uint64_t) segment->bytes,
+                    (uint32_t) bytes,
+                    (uint32_t) frame.status
+                });
+
+                if (segment->records.size() >= INDEX_BATCH_SIZE) {
+                    segment->index.write((const char*) segment->records.data(), segment->records.size() * sizeof(A3CIndexRecord));
+                    segment->records.clear();
+                }
+
+            }
+
+            if (latencyTracking) {
+                recordLatencies(frame);
+            }
+
+            if (segment->firstSequence < 0) {
+                segment->firstSequence  = frame.sequence;
+                segment->firstTimestamp = frame.metadata.timestamp;
+            }
+
+            segment->lastSequence  = frame.sequence;
+            segment->lastTimestamp = frame.metadata.timestamp;
+
+            segment->header.frameCount++;
+            segment->bytes += bytes;
+            writtenBytes   += bytes;
+
+        }
+
+        retire(segment.release());
+        closing.push(nullptr);
+        closer.join();
+
+        *out << endl;
+
+        return 0;
+    }
+
+    /// @brief Adds how long a frame just written spent in each stage to the samples
+    /// kept for getLatencies().
+    void recordLatencies(Frame& frame) {
+
+        vector<double>& total = latencies["total"];
+
+        if (total.size() >= LATENCY_SAMPLE_LIMIT) {
+            return;
+        }
+
+        auto written = chrono::steady_clock::now();
+        auto micros  = [](chrono::steady_clock::duration elapsed) {
+            return chrono::duration<double, micro>(elapsed).count();
+        };
+
+        latencies["process"].push_back(micros(frame.processed - frame.acquired));
+        latencies["reorder"].push_back(micros(frame.ordered - frame.processed));
+        latencies["write"].push_back(micros(written - frame.ordered));
+        total.push_back(micros(written - frame.acquired));
+
+    }
+
+    int monitor() {
+
+        long last = time(0);
+        long lastAcquireCount = 0;
+        long lastProcessCount = 0;
+        long lastWriteCount   = 0;
+        long lastWrittenBytes = 0;
+        long lastRawBytes     = 0;
+        long lastPackedBytes  = 0;
+
+        double lastPackSeconds = 0;
+
+        this_thread::sleep_for(chrono::seconds(1));
+
+        *out << "...";
+
+        while (monitoring) {
 
             if (running) {
 
@@ -307,30 +1658,97 @@ public:
                 double aRate    = (acquireCount - lastAcquireCount) / duration;
                 double pRate    = (processCount - lastProcessCount) / duration;
                 double wRate    = (writeCount - lastWriteCount) / duration;
-                double temp     = getFloat(handle, "SensorTemperature");
-                int    pQueue   = processQueue.size();
+                double mbRate   = (writtenBytes - lastWrittenBytes) / (1e6 * duration);
+                int    pQueue   = getProcessQueueSize();
                 int    wQueue   = writeQueue.size();
+                int    inUse    = pool.inUse();
+                long   stalls   = pool.getStalls();
 
                 lastAcquireCount = acquireCount;
                 lastProcessCount = processCount;
                 lastWriteCount   = writeCount;
+                lastWrittenBytes = writtenBytes;
                 last             = time(0);
 
                 *out << "\r\e[K"
-                    << "A = " << aRate << " Hz, P = " << pRate << " Hz, "
-                    << ", W = " << wRate << " Hz, PQ = " << pQueue << ", WQ = " << wQueue;
+                    << "A = " << aRate << " Hz, P = " << pRate << " Hz [";
+
+                for (int i = 0; i < (int) workers.size(); i++) {
+
+                    Worker *worker    = workers[i].get();
+                    long    count     = worker->count;
+                    worker->fps       = (count - worker->lastCount) / duration;
+                    worker->lastCount = count;
+
+                    *out << (i > 0 ? ", " : "") << worker->fps;
+
+                }
+
+                *out << "], RB = " << reorderDepth
+                    << ", W = " << wRate << " Hz";
+
+                // Each frame written is a sum, so this is the effective output frame rate
+                if (isCoadding()) {
+                    *out << " of " << coaddFrames << "-frame sums";
+                }
+
+                *out << " (" << mbRate << " MB/s";
+
+                if (diskBandwidth > 0) {
+                    *out << ", " << (int) (100.0 * mbRate / diskBandwidth) << "% of disk";
+                }
+
+                *out << ")";
+
+                // Compression ratio over the last period, and how fast each worker compresses
+                if (isCompressing()) {
+
+                    long   rawBytes = 0, packedBytes = 0;
+                    double packSeconds = 0;
+
+                    for (auto &worker : workers) {
+                        rawBytes    += worker->rawBytes;
+                        packedBytes += worker->packedBytes;
+                        packSeconds += worker->packSeconds;
+                    }
+
+                    if (packedBytes > lastPackedBytes && packSeconds > lastPackSeconds) {
+                        packRatio = (double) (rawBytes - lastRawBytes) / (packedBytes - lastPackedBytes);
+                        packRate  = (rawBytes - lastRawBytes) / (1e6 * (packSeconds - lastPackSeconds));
+                    }
+
+                    lastRawBytes    = rawBytes;
+                    lastPackedBytes = packedBytes;
+                    lastPackSeconds = packSeconds;
+
+                    *out << ", C = " << packRatio << "x (" << packRate << " MB/s per thread)";
+
+                }
+
+                *out << ", PQ = " << pQueue << " (max " << getProcessQueueHighWatermark() << ")"
+                    << ", WQ = " << wQueue << " (max " << writeQueue.getHighWatermark() << ")"
+                    << ", Pool = " << inUse << "/" << pool.capacity() << ", Stalls = " << stalls
+                    << ", Dropped = " << dropped << ", Late = " << late;
+
+
+                acquireFPS = aRate;
+                processFPS = pRate;
+                writeFPS   = wRate;
+                writeRate  = mbRate;
 
             } else {
 
-                *out << "\r\e[K" << "Stopping threads: Left to Process = " << processQueue.size() << ", Left to Write = " << writeQueue.size();
+                *out << "\r\e[K" << "Stopping threads: Left to Process = " << getProcessQueueSize() << ", Left to Write = " << writeQueue.size();
 
             }
 
+            lock_guard<mutex> guard(errorLock);
+
             if (!errors.empty()) {
 
                 *out << endl;
 
-                for (int i = 0; i < errors.size(); i++) {
+                for (size_t i = 0; i < errors.size(); i++) {
                     *out << errors[i] << endl;
                 }
 
@@ -338,6 +1756,8 @@ public:
 
             }
 
+            out->flush();
+
             this_thread::sleep_for(chrono::seconds(1));
 
         }
@@ -348,5 +1768,115 @@ public:
         return 0;
 
     }
-    
+
+    long getAcquireFPS() {
+        return acquireFPS;
+    }
+
+    long getProcessFPS() {
+        return processFPS;
+    }
+
+    long getWriteFPS() {
+        return writeFPS;
+    }
+
+    double getWriteRate() {
+        return writeRate;
+    }
+
+    /// @brief Raw bytes per compressed byte over the last second (0 if not compressing).
+    double getCompressionRatio() {
+        return packRatio;
+    }
+
+    /// @brief Speed (in MB/s of raw frames) that each processing thread compresses at.
+    double getCompressionRate() {
+        return packRate;
+    }
+
+    double getDiskBandwidth() {
+        return diskBandwidth;
+    }
+
+    /// @brief Number of segments started so far in the current (or last) capture.
+    long getSegmentCount() {
+        return segmentCount;
+    }
+
+    long getWrittenBytes() {
+        return writtenBytes;
+    }
+
+    long getProcessQueueSize() {
+
+        long size = 0;
+
+        for (auto &worker : workers) {
+            size += worker->input.size();
+        }
+
+        return size;
+
+    }
+
+    long getWorkerFPS(int index) {
+        return index >= 0 && index < (int) workers.size() ? workers[index]->fps : 0;
+    }
+
+    long getReorderDepth() {
+        return reorderDepth;
+    }
+
+    long getDroppedFrames() {
+        return dropped;
+    }
+
+    long getLateFrames() {
+        return late;
+    }
+
+    long getTimestampDiscontinuities() {
+        return jumps;
+    }
+
+    long getWriteQueueSize() {
+        return writeQueue.size();
+    }
+
+    long getProcessQueueHighWatermark() {
+
+        long highest = 0;
+
+        for (auto &worker : workers) {
+            highest = max(highest, worker->input.getHighWatermark());
+        }
+
+        return highest;
+
+    }
+
+    long getWriteQueueHighWatermark() {
+        return writeQueue.getHighWatermark();
+    }
+
+    long getPoolInUse() {
+        return pool.inUse();
+    }
+
+    long getPoolStalls() {
+        return pool.getStalls();
+    }
+
+    long getAcquireCount() {
+        return acquireCount;
+    }
+
+    bool isRunning() {
+        return running;
+    }
+
+    bool isMonitoring() {
+        return monitoring;
+    }
 };
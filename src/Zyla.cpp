@@ -1,6 +1,10 @@
-#include "atfunc.cpp"
-#include "queue.cpp"
+#include "A3C.cpp"
+#include <algorithm>
+#include <climits>
+#include <condition_variable>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <ctime>
 #include <fstream>
 #include <thread>
@@ -9,417 +13,6 @@
 
 bool initialised = false;
 
-std::map<int, std::string> errorNames {
-
-    {AT_SUCCESS, "SUCCESS"},
-    {AT_ERR_NOTINITIALISED, "ERR_NOTINITIALISED"},
-    {AT_ERR_NOTIMPLEMENTED, "ERR_NOTIMPLEMENTED"},
-    {AT_ERR_READONLY, "ERR_READONLY"},
-    {AT_ERR_NOTREADABLE, "ERR_NOTREADABLE"},
-    {AT_ERR_NOTWRITABLE, "ERR_NOTWRITABLE"},
-    {AT_ERR_OUTOFRANGE, "ERR_OUTOFRANGE"},
-    {AT_ERR_INDEXNOTAVAILABLE, "ERR_INDEXNOTAVAILABLE"},
-    {AT_ERR_INDEXNOTIMPLEMENTED, "ERR_INDEXNOTIMPLEMENTED"},
-    {AT_ERR_EXCEEDEDMAXSTRINGLENGTH, "ERR_EXCEEDEDMAXSTRINGLENGTH"},
-    {AT_ERR_CONNECTION, "ERR_CONNECTION"},
-    {AT_ERR_NODATA, "ERR_NODATA"},
-    {AT_ERR_INVALIDHANDLE, "ERR_INVALIDHANDLE"},
-    {AT_ERR_TIMEDOUT, "ERR_TIMEDOUT"},
-    {AT_ERR_BUFFERFULL, "ERR_BUFFERFULL"},
-    {AT_ERR_INVALIDSIZE, "ERR_INVALIDSIZE"},
-    {AT_ERR_INVALIDALIGNMENT, "ERR_INVALIDALIGNMENT"},
-    {AT_ERR_COMM, "ERR_COMM"},
-    {AT_ERR_STRINGNOTAVAILABLE, "ERR_STRINGNOTAVAILABLE"},
-    {AT_ERR_STRINGNOTIMPLEMENTED, "ERR_STRINGNOTIMPLEMENTED"},
-    {AT_ERR_NULL_FEATURE, "ERR_NULL_FEATURE"},
-    {AT_ERR_NULL_HANDLE, "ERR_NULL_HANDLE"},
-    {AT_ERR_NULL_IMPLEMENTED_VAR, "ERR_NULL_IMPLEMENTED_VAR"},
-    {AT_ERR_NULL_READABLE_VAR, "ERR_NULL_READABLE_VAR"},
-    {AT_ERR_NULL_READONLY_VAR, "ERR_NULL_READONLY_VAR"},
-    {AT_ERR_NULL_WRITABLE_VAR, "ERR_NULL_WRITABLE_VAR"},
-    {AT_ERR_NULL_MINVALUE, "ERR_NULL_MINVALUE"},
-    {AT_ERR_NULL_MAXVALUE, "ERR_NULL_MAXVALUE"},
-    {AT_ERR_NULL_VALUE, "ERR_NULL_VALUE"},
-    {AT_ERR_NULL_STRING, "ERR_NULL_STRING"},
-    {AT_ERR_NULL_COUNT_VAR, "ERR_NULL_COUNT_VAR"},
-    {AT_ERR_NULL_ISAVAILABLE_VAR, "ERR_NULL_ISAVAILABLE_VAR"},
-    {AT_ERR_NULL_MAXSTRINGLENGTH, "ERR_NULL_MAXSTRINGLENGTH"},
-    {AT_ERR_NULL_EVCALLBACK, "ERR_NULL_EVCALLBACK"},
-    {AT_ERR_NULL_QUEUE_PTR, "ERR_NULL_QUEUE_PTR"},
-    {AT_ERR_NULL_WAIT_PTR, "ERR_NULL_WAIT_PTR"},
-    {AT_ERR_NULL_PTRSIZE, "ERR_NULL_PTRSIZE"},
-    {AT_ERR_NOMEMORY, "ERR_NOMEMORY"},
-    {AT_ERR_DEVICEINUSE, "ERR_DEVICEINUSE"},
-    {AT_ERR_DEVICENOTFOUND, "ERR_DEVICENOTFOUND"},
-    {AT_ERR_HARDWARE_OVERFLOW, "ERR_HARDWARE_OVERFLOW"}
-
-};
-
-class A3C {
-   private:
-
-    AT_H   handle;
-    string outputPath;
-    int    frameLimit;
-    int    imageSize;
-
-    thread acquireThread;
-    thread processThread;
-    thread writeThread;
-    thread monitorThread;
-
-    FIFOQueue<unsigned char *>  processQueue;
-    FIFOQueue<unsigned short *> writeQueue;
-
-    vector<string> errors;
-
-    ostream* out          = &cout;
-    bool     running      = false;
-    bool     monitoring   = false;
-    long     acquireCount = 0;
-    long     processCount = 0;
-    long     writeCount   = 0;
-    long     acquireFPS   = 0;
-    long     processFPS   = 0;
-    long     writeFPS     = 0;
-
-   public:
-
-    A3C(const A3C& other) {
-        
-        this->handle     = other.handle;
-        this->outputPath = other.outputPath;
-        this->frameLimit = other.frameLimit;
-
-    }
-
-    A3C(AT_H handle) {
-
-        this->handle     = handle;
-        this->outputPath = "output.h5";
-        this->frameLimit = -1;
-
-        // Check that the camera is connected
-        int result = AT_Flush(handle);
-
-        if (result != AT_SUCCESS) {
-            throw errorNames[result];
-        }
-        
-    }
-
-    void setVerbose(bool flag) {
-        out = flag ? &cout : new ostream(0);
-    }
-
-    void setFrameLimit(int limit) {
-        frameLimit = limit;
-    }
-
-    void setOutputPath(std::string path) {
-        outputPath = path;
-    }
-
-    int getFrameLimit() {
-        return frameLimit;
-    }
-
-    std::string getOutputPath() {
-        return outputPath;
-    }
-
-    void start() {
-
-        // Set both flags to true so that loops do the looping
-        running    = true;
-        monitoring = true;
-
-        // Clear both queues
-        processQueue.clear();
-        writeQueue.clear();
-
-        // Set all threads running
-        *out << "Starting writing thread... ";
-        writeThread = thread(&A3C::write, this);
-        *out << "Done." << endl;
-
-        *out << "Starting processing thread... ";
-        processThread = thread(&A3C::process, this);
-        *out << "Done." << endl;
-
-        *out << "Starting acquisition thread... ";
-        acquireThread = thread(&A3C::acquire, this);
-        *out << "Done." << endl;
-
-        *out << "Starting monitoring thread... ";
-        monitorThread = thread(&A3C::monitor, this);
-        *out << "Done." << endl;
-        
-    }
-
-    void stop() {
-
-        // Indicate to all threads that we wish to stop
-        running = false;
-
-        // Wait for the acquisition thread to stop
-        acquireThread.join();
-
-        // Push a null pointer to the processing queue, in case it is currently
-        // blocking then wait for it to finish
-        processQueue.push(nullptr);
-        processThread.join();
-
-        // Same for writing queue
-        writeQueue.push(nullptr);
-        writeThread.join();
-
-        // Tell the monitoring thread to stop and wait for it to do so
-        monitoring = false;
-        monitorThread.join();
-
-    }
-
-    int acquire() {
-
-        // Declare variables
-        unsigned char* pBuffer;
-        int            size = 0;
-        long           start = time(0);
-        double         temperature;
-
-        // Calculate timeout to use for acquisitions in ms (min 500 ms)
-        float  frameRate  = getFloat(handle, "FrameRate");
-        float  frameTime  = 1.0 / frameRate;
-        long   time       = (long) (1000.0 * 2.0 * frameTime);
-        long   timeOut    = time > 500 ? time : 500;
-
-        // Tell the camera to include metadata and to continuously capture
-        setBool(handle, "MetadataEnable", true);
-        setBool(handle, "MetadataFrameInfo", true);
-        setBool(handle, "MetadataTimestamp", true);
-        setBool(handle, "MetadataEnable", true);
-        setEnum(handle, "CycleMode", "Continuous");
-
-        // Query camera for buffer size
-        imageSize = getInt(handle, "ImageSizeBytes");
-
-        // Start the acquisition
-        AT_Command(handle, L"AcquisitionStart");
-
-        for (acquireCount = 0; running && (frameLimit <= 0 || acquireCount < frameLimit); acquireCount++) {
-
-            // Create new buffer, queue it and await data
-            unsigned char *buffer = new unsigned char[imageSize];
-            int            qCode  = AT_QueueBuffer(handle, buffer, imageSize);
-            int            wCode  = AT_WaitBuffer(handle, &pBuffer, &size, timeOut);
-
-            // If there was an error, record it and restart acquisition
-            if (qCode != AT_SUCCESS || wCode != AT_SUCCESS) {
-
-                if (wCode == 13) {
-                    errors.push_back("Acquisition Time-Out (" + to_string(qCode) + ", " + to_string(wCode) + "), restarting acquisition.");
-                } else {
-                    errors.push_back("Error (" + to_string(qCode) + ", " + to_string(wCode) + "), restarting acquisition.");
-                }
-
-                AT_Command(handle, L"AcquisitionStop");
-                AT_Flush(handle);
-                AT_Command(handle, L"AcquisitionStart");
-
-                continue;
-
-            }
-
-            // Push the buffer into the processing queue
-            processQueue.push(pBuffer);
-
-        }
-
-        running = false;
-
-        // Stop acquisition and flush through any remaining buffers
-        AT_Command(handle, L"AcquisitionStop");
-        AT_Flush(handle);
-
-        return 0;
-
-    }
-
-    int process() {
-
-        // Keep going so long as we're runnning, or there's still frames to process in the queue
-        for (processCount = 0; running || processQueue.hasWaiting(); processCount++) {
-
-            // Get next frame in queue, if none present then this blocks (waits) until there is one
-            unsigned char *buffer = processQueue.pop();
-
-            // If we've been given a nullt pointer, ignore it
-            if (buffer == nullptr) {
-                continue;
-            }
-
-            // Extract timestamp and image size from meta data
-            AT_64 timestamp;
-            AT_64 imageHeight;
-            AT_64 imageWidth;
-            AT_GetTimeStampFromMetadata(buffer, imageSize, timestamp);
-            AT_GetWidthFromMetadata(buffer, imageSize, imageWidth);
-            AT_GetHeightFromMetadata(buffer, imageSize, imageHeight);
-
-            int size = imageWidth * imageHeight;
-
-            // Create buffer for processed image
-            unsigned short *converted = new unsigned short[size];
-
-            // Convert image into an array of shorts (i.e., 16-bit integers) without padding etc
-            AT_ConvertBufferUsingMetadata(buffer, (unsigned char *)converted, imageSize, L"Mono16");
-
-            // Push to the converted image back of the write queue
-            writeQueue.push(converted);
-
-            // Free the original image's memory
-            delete[] buffer;
-        }
-
-        return 0;
-
-    }
-
-    int write() {
-
-        remove(outputPath.c_str());
-
-        ofstream output = ofstream(outputPath, ios::binary | ios::out);
-
-        long imageHeight = getInt(handle, "AOIHeight");
-        long imageWidth  = getInt(handle, "AOIWidth");
-        long size        = imageHeight * imageWidth;
-
-        for (writeCount = 0; running || writeQueue.hasWaiting(); writeCount++) {
-
-            unsigned short *buffer = writeQueue.pop();
-
-            if (buffer == nullptr) {
-                continue;
-            }
-
-            for (int i = 0; i < size; i++) {
-                output << buffer[i];
-            }
-
-            delete[] buffer;
-
-        }
-
-        *out << endl;
-
-        output.close();
-
-        return 0;
-    }
-
-    int monitor() {
-
-        long last = time(0);
-        long lastAcquireCount = 0;
-        long lastProcessCount = 0;
-        long lastWriteCount   = 0;
-
-        this_thread::sleep_for(chrono::seconds(1));
-
-        *out << "...";
-
-        while (monitoring) {
-
-            if (running) {
-
-                long   duration = time(0) - last;
-                double aRate    = (acquireCount - lastAcquireCount) / duration;
-                double pRate    = (processCount - lastProcessCount) / duration;
-                double wRate    = (writeCount - lastWriteCount) / duration;
-                double temp     = getFloat(handle, "SensorTemperature");
-                int    pQueue   = processQueue.size();
-                int    wQueue   = writeQueue.size();
-
-                lastAcquireCount = acquireCount;
-                lastProcessCount = processCount;
-                lastWriteCount   = writeCount;
-                last             = time(0);
-
-                *out << "\r\e[K"
-                    << "A = " << aRate << " Hz, P = " << pRate << " Hz, "
-                    << ", W = " << wRate << " Hz, PQ = " << pQueue << ", WQ = " << wQueue;
-
-
-                acquireFPS = aRate;
-                processFPS = pRate;
-                writeFPS   = wRate;
-
-            } else {
-
-                *out << "\r\e[K" << "Stopping threads: Left to Process = " << processQueue.size() << ", Left to Write = " << writeQueue.size();
-
-            }
-
-            if (!errors.empty()) {
-
-                *out << endl;
-
-                for (int i = 0; i < errors.size(); i++) {
-                    *out << errors[i] << endl;
-                }
-
-                errors.clear();
-
-            }
-
-            out->flush();
-
-            this_thread::sleep_for(chrono::seconds(1));
-
-        }
-
-        *out << "\r\e[K" << "Shutdown complete." << endl;
-        *out << "Total frames written to disk: " << writeCount << endl;
-
-        return 0;
-
-    }
-
-    long getAcquireFPS() {
-        return acquireFPS;
-    }
-
-    long getProcessFPS() {
-        return processFPS;
-    }
-
-    long getWriteFPS() {
-        return writeFPS;
-    }
-
-    long getProcessQueueSize() {
-        return processQueue.size();
-    }
-
-    long getWriteQueueSize() {
-        return writeQueue.size();
-    }
-
-    long getAcquireCount() {
-        return acquireCount;
-    }
-
-    bool isRunning() {
-        return running;
-    }
-
-    bool isMonitoring() {
-        return monitoring;
-    }
-};
-
 class Track {
 
     private:
@@ -476,34 +69,26 @@ class Acquisition {
     
     private:
 
-    unsigned short* data;
+    // Shared rather than copied, so that copies (e.g., those SWIG makes when returning
+    // one by value) and NumPy arrays made from them all point at the same pixels
+    std::shared_ptr<unsigned short[]> data;
     long width  = 0;
     long height = 0;
     long size   = 0;
 
     public:
      
+    /// @brief Takes ownership of data, which must have been allocated with new[].
     Acquisition(unsigned short* data, long width, long height) {
-        this->data   = data;
+        this->data   = std::shared_ptr<unsigned short[]>(data);
         this->width  = width;
         this->height = height;
         this->size   = width * height;
     }
 
-    Acquisition(const Acquisition& other) {
-        this->width  = other.width;
-        this->height = other.height;
-        this->size   = other.size;
-        this->data   = new unsigned short[size];
-
-        for (int i = 0; i < size; i++) {
-            data[i] = other.data[i];
-        }
-
-    }
-
-    ~Acquisition() {
-        delete[] data;
+    /// @brief The pixels, for as long as something holds on to the returned pointer.
+    std::shared_ptr<unsigned short[]> share() {
+        return data;
     }
 
     long getWidth() {
@@ -519,7 +104,7 @@ class Acquisition {
     }
 
     std::vector<unsigned short> getArray() {
-        return std::vector<unsigned short>(data, data + size);
+        return std::vector<unsigned short>(data.get(), data.get() + size);
     }
 
     unsigned short getPixel(int row, int column) {
@@ -554,50 +139,113 @@ class Acquisition {
 
 };
 
-class Zyla {
+/// @brief A run of frames captured in one go by Zyla::acquireBurst(), as a single
+/// block of count x height x width Mono16 pixels, along with the hardware timestamp
+/// of each frame. Like Acquisition, copies share the same pixels.
+class Burst {
 
     private:
 
-    AT_H handle;
-    A3C  *pipeline;
+    std::shared_ptr<unsigned short[]> data;
+    std::shared_ptr<long long[]>      timestamps;
+    long count          = 0;
+    long width          = 0;
+    long height         = 0;
+    long clockFrequency = 0;
 
     public:
 
-    Zyla(int index) {
-        
-        if (!initialised) {
-            AT_InitialiseLibrary();
-            AT_InitialiseUtilityLibrary();
-            initialised = true;
+    /// @brief Takes ownership of data and timestamps, which must have been allocated with new[].
+    Burst(unsigned short* data, long long* timestamps, long count, long width, long height, long clockFrequency) {
+        this->data           = std::shared_ptr<unsigned short[]>(data);
+        this->timestamps     = std::shared_ptr<long long[]>(timestamps);
+        this->count          = count;
+        this->width          = width;
+        this->height         = height;
+        this->clockFrequency = clockFrequency;
+    }
+
+    long getCount() {
+        return count;
+    }
+
+    long getWidth() {
+        return width;
+    }
+
+    long getHeight() {
+        return height;
+    }
+
+    long getClockFrequency() {
+        return clockFrequency;
+    }
+
+    /// @brief Hardware timestamp of the given frame, in clock ticks.
+    long long getTimestamp(long frame) {
+
+        if (frame < 0 || frame >= count) {
+            throw std::string("Frame index out of range");
         }
 
-        int result = AT_Open(index, &handle);
+        return timestamps[frame];
 
+    }
 
-        if (result != AT_SUCCESS) {
-            throw errorNames[result];
+    /// @brief Hardware timestamp of the given frame, in seconds.
+    double getTime(long frame) {
+        return clockFrequency > 0 ? (double) getTimestamp(frame) / clockFrequency : 0.0;
+    }
+
+    unsigned short getPixel(long frame, int row, int column) {
+
+        if (frame < 0 || frame >= count) {
+            throw std::string("Frame index out of range");
         }
 
-        pipeline = new A3C(handle);
+        if (row < 0 || row >= height) {
+            throw std::string("Row index out of range");
+        }
+
+        if (column < 0 || column >= width) {
+            throw std::string("Column index out of range");
+        }
+
+        return data[(frame * height + row) * width + column];
 
     }
 
-    ~Zyla() {
-        delete pipeline;
+    /// @brief The pixels, for as long as something holds on to the returned pointer.
+    std::shared_ptr<unsigned short[]> share() {
+        return data;
     }
 
-    A3C capturePipeline() {
-        return *pipeline;
+    /// @brief The timestamps, for as long as something holds on to the returned pointer.
+    std::shared_ptr<long long[]> shareTimestamps() {
+        return timestamps;
     }
 
-    long getInt(std::string feature) {
+};
+
+class Zyla {
+
+    private:
+
+    AT_H handle;
+    A3C  *pipeline;
+
+    // Feature access by wide-character name. Names known when compiling are passed
+    // straight in as literals, and the rest are looked up once with internWC(), so
+    // none of these allocate.
+
+    long getInt(const AT_WC* feature) {
 
         AT_64 value;
-        int result = AT_GetInt(handle, stringToWC(feature), &value);
+        int result = AT_GetInt(handle, feature, &value);
 
         if (result != AT_SUCCESS) {
             ostringstream oss;
-            oss << feature << ": " << errorNames[result] << " (" << result << ")";
+            oss << wcTostring(feature) << ": " << errorNames[result] << " (" << result << ")";
             throw oss.str();
         }
 
@@ -605,26 +253,26 @@ class Zyla {
 
     }
 
-    void setInt(std::string feature, long value) {
+    void setInt(const AT_WC* feature, long value) {
 
-        int result = AT_SetInt(handle, stringToWC(feature), value);
+        int result = AT_SetInt(handle, feature, value);
 
         if (result != AT_SUCCESS) {
             ostringstream oss;
-            oss << feature << ": " << errorNames[result] << " (" << result << ")";
+            oss << wcTostring(feature) << ": " << errorNames[result] << " (" << result << ")";
             throw oss.str();
         }
 
     }
 
-    long getIntMin(std::string feature) {
+    long getIntMin(const AT_WC* feature) {
 
         AT_64 value;
-        int result = AT_GetIntMin(handle, stringToWC(feature), &value);
+        int result = AT_GetIntMin(handle, feature, &value);
 
         if (result != AT_SUCCESS) {
             ostringstream oss;
-            oss << feature << ": " << errorNames[result] << " (" << result << ")";
+            oss << wcTostring(feature) << ": " << errorNames[result] << " (" << result << ")";
             throw oss.str();
         }
 
@@ -632,14 +280,14 @@ class Zyla {
 
     }
 
-    long getIntMax(std::string feature) {
+    long getIntMax(const AT_WC* feature) {
 
         AT_64 value;
-        int result = AT_GetIntMax(handle, stringToWC(feature), &value);
+        int result = AT_GetIntMax(handle, feature, &value);
 
         if (result != AT_SUCCESS) {
             ostringstream oss;
-            oss << feature << ": " << errorNames[result] << " (" << result << ")";
+            oss << wcTostring(feature) << ": " << errorNames[result] << " (" << result << ")";
             throw oss.str();
         }
 
@@ -647,14 +295,14 @@ class Zyla {
 
     }
 
-    bool getBool(std::string feature) {
+    bool getBool(const AT_WC* feature) {
 
         AT_BOOL value;
-        int result = AT_GetBool(handle, stringToWC(feature), &value);
+        int result = AT_GetBool(handle, feature, &value);
 
         if (result != AT_SUCCESS) {
             ostringstream oss;
-            oss << feature << ": " << errorNames[result] << " (" << result << ")";
+            oss << wcTostring(feature) << ": " << errorNames[result] << " (" << result << ")";
             throw oss.str();
         }
 
@@ -662,26 +310,26 @@ class Zyla {
 
     }
 
-    void setBool(std::string feature, bool value) {
+    void setBool(const AT_WC* feature, bool value) {
 
-        int result = AT_SetBool(handle, stringToWC(feature), value);
+        int result = AT_SetBool(handle, feature, value);
 
         if (result != AT_SUCCESS) {
             ostringstream oss;
-            oss << feature << ": " << errorNames[result] << " (" << result << ")";
+            oss << wcTostring(feature) << ": " << errorNames[result] << " (" << result << ")";
             throw oss.str();
         }
 
     }
 
-    double getFloat(std::string feature) {
+    double getFloat(const AT_WC* feature) {
 
         double value;
-        int result = AT_GetFloat(handle, stringToWC(feature), &value);
+        int result = AT_GetFloat(handle, feature, &value);
 
         if (result != AT_SUCCESS) {
             ostringstream oss;
-            oss << feature << ": " << errorNames[result] << " (" << result << ")";
+            oss << wcTostring(feature) << ": " << errorNames[result] << " (" << result << ")";
             throw oss.str();
         }
 
@@ -689,14 +337,14 @@ class Zyla {
 
     }
 
-    double getFloatMin(std::string feature) {
+    double getFloatMin(const AT_WC* feature) {
 
         double value;
-        int result = AT_GetFloatMin(handle, stringToWC(feature), &value);
+        int result = AT_GetFloatMin(handle, feature, &value);
 
         if (result != AT_SUCCESS) {
             ostringstream oss;
-            oss << feature << ": " << errorNames[result] << " (" << result << ")";
+            oss << wcTostring(feature) << ": " << errorNames[result] << " (" << result << ")";
             throw oss.str();
         }
 
@@ -704,14 +352,14 @@ class Zyla {
 
     }
 
-    double getFloatMax(std::string feature) {
+    double getFloatMax(const AT_WC* feature) {
 
         double value;
-        int result = AT_GetFloatMax(handle, stringToWC(feature), &value);
+        int result = AT_GetFloatMax(handle, feature, &value);
 
         if (result != AT_SUCCESS) {
             ostringstream oss;
-            oss << feature << ": " << errorNames[result] << " (" << result << ")";
+            oss << wcTostring(feature) << ": " << errorNames[result] << " (" << result << ")";
             throw oss.str();
         }
 
@@ -719,26 +367,26 @@ class Zyla {
 
     }
 
-    void setFloat(std::string feature, double value) {
+    void setFloat(const AT_WC* feature, double value) {
 
-        int result = AT_SetFloat(handle, stringToWC(feature), value);
+        int result = AT_SetFloat(handle, feature, value);
 
         if (result != AT_SUCCESS) {
             ostringstream oss;
-            oss << feature << ": " << errorNames[result] << " (" << result << ")";
+            oss << wcTostring(feature) << ": " << errorNames[result] << " (" << result << ")";
             throw oss.str();
         }
 
     }
 
-    int getEnumInt(std::string feature) {
+    int getEnumInt(const AT_WC* feature) {
 
         int value;
-        int result = AT_GetEnumIndex(handle, stringToWC(feature), &value);
+        int result = AT_GetEnumIndex(handle, feature, &value);
 
         if (result != AT_SUCCESS) {
             ostringstream oss;
-            oss << feature << ": " << errorNames[result] << " (" << result << ")";
+            oss << wcTostring(feature) << ": " << errorNames[result] << " (" << result << ")";
             throw oss.str();
         }
 
@@ -746,36 +394,42 @@ class Zyla {
 
     }
 
-    void setEnumInt(std::string feature, int index) {
+    void setEnumInt(const AT_WC* feature, int index) {
 
-        int result = AT_SetEnumIndex(handle, stringToWC(feature), index);
+        int result = AT_SetEnumIndex(handle, feature, index);
 
         if (result != AT_SUCCESS) {
             ostringstream oss;
-            oss << feature << ": " << errorNames[result] << " (" << result << ")";
+            oss << wcTostring(feature) << ": " << errorNames[result] << " (" << result << ")";
             throw oss.str();
         }
         
     }
 
-    std::string getEnum(std::string feature) {
+    std::string getEnum(const AT_WC* feature) {
 
-        int    value  = getEnumInt(feature);
-        AT_WC* chars  = new AT_WC[1024];
-        int    result = AT_GetEnumStringByIndex(handle, stringToWC(feature), value, chars, 1024);
+        int   value = getEnumInt(feature);
+        AT_WC chars[1024];
+        int   result = AT_GetEnumStringByIndex(handle, feature, value, chars, 1024);
+
+        if (result != AT_SUCCESS) {
+            ostringstream oss;
+            oss << wcTostring(feature) << ": " << errorNames[result] << " (" << result << ")";
+            throw oss.str();
+        }
 
         return wcTostring(chars);
 
     }
 
-    std::string getString(std::string feature) {
+    std::string getString(const AT_WC* feature) {
 
-        AT_WC* chars  = new AT_WC[1024];
-        int    result = AT_GetString(handle, stringToWC(feature), chars, 1024);
+        AT_WC chars[1024];
+        int   result = AT_GetString(handle, feature, chars, 1024);
 
         if (result != AT_SUCCESS) {
             ostringstream oss;
-            oss << feature << ": " << errorNames[result] << " (" << result << ")";
+            oss << wcTostring(feature) << ": " << errorNames[result] << " (" << result << ")";
             throw oss.str();
         }
 
@@ -783,40 +437,38 @@ class Zyla {
 
     }
 
-    void setEnum(std::string feature, std::string value) {
+    void setEnum(const AT_WC* feature, const AT_WC* value) {
 
-        int result = AT_SetEnumString(handle, stringToWC(feature), stringToWC(value));
+        int result = AT_SetEnumString(handle, feature, value);
 
         if (result != AT_SUCCESS) {
             ostringstream oss;
-            oss << feature << " = " << value << ": " << errorNames[result] << " (" << result << ")";
+            oss << wcTostring(feature) << " = " << wcTostring(value) << ": " << errorNames[result] << " (" << result << ")";
             throw oss.str();
         }
 
     }
 
-    void command(std::string feature) {
+    void command(const AT_WC* feature) {
 
-        int result = AT_Command(handle, stringToWC(feature));
+        int result = AT_Command(handle, feature);
 
         if (result != AT_SUCCESS) {
             ostringstream oss;
-            oss << feature << ": " << errorNames[result] << " (" << result << ")";
+            oss << wcTostring(feature) << ": " << errorNames[result] << " (" << result << ")";
             throw oss.str();
         }
 
     }
 
-    std::map<int, std::string> getEnumOptions(std::string feature) {
-
-        AT_WC* ft = stringToWC(feature);
+    std::map<int, std::string> getEnumOptions(const AT_WC* feature) {
 
         int count;
-        int result = AT_GetEnumeratedCount(handle, ft, &count);
+        int result = AT_GetEnumeratedCount(handle, feature, &count);
 
         if (result != AT_SUCCESS) {
             ostringstream oss;
-            oss << feature << ": " << errorNames[result] << " (" << result << ")";
+            oss << wcTostring(feature) << ": " << errorNames[result] << " (" << result << ")";
             throw oss.str();
         }
 
@@ -826,9 +478,9 @@ class Zyla {
             AT_BOOL available;
             AT_BOOL implemented;
 
-            int result1 = AT_IsEnumeratedIndexAvailable(handle, ft, i, &available);
+            int result1 = AT_IsEnumeratedIndexAvailable(handle, feature, i, &available);
             int result2 =
-                AT_IsEnumeratedIndexImplemented(handle, ft, i, &implemented);
+                AT_IsEnumeratedIndexImplemented(handle, feature, i, &implemented);
 
             if (result1 != AT_SUCCESS || result2 != AT_SUCCESS) {
                 continue;
@@ -836,7 +488,7 @@ class Zyla {
 
             if (available && implemented) {
                 AT_WC chars[1024];
-                AT_GetEnumStringByIndex(handle, ft, i, chars, 1024);
+                AT_GetEnumStringByIndex(handle, feature, i, chars, 1024);
                 options[i] = wcTostring(chars);
             }
         }
@@ -845,6 +497,103 @@ class Zyla {
 
     }
 
+    public:
+
+    Zyla(int index) {
+        
+        if (!initialised) {
+            AT_InitialiseLibrary();
+            AT_InitialiseUtilityLibrary();
+            initialised = true;
+        }
+
+        int result = AT_Open(index, &handle);
+
+
+        if (result != AT_SUCCESS) {
+            throw errorNames[result];
+        }
+
+        pipeline = new A3C(handle);
+
+    }
+
+    ~Zyla() {
+        delete pipeline;
+    }
+
+    A3C capturePipeline() {
+        return *pipeline;
+    }
+
+    long getInt(std::string feature) {
+        return getInt(internWC(feature));
+    }
+
+    void setInt(std::string feature, long value) {
+        setInt(internWC(feature), value);
+    }
+
+    long getIntMin(std::string feature) {
+        return getIntMin(internWC(feature));
+    }
+
+    long getIntMax(std::string feature) {
+        return getIntMax(internWC(feature));
+    }
+
+    bool getBool(std::string feature) {
+        return getBool(internWC(feature));
+    }
+
+    void setBool(std::string feature, bool value) {
+        setBool(internWC(feature), value);
+    }
+
+    double getFloat(std::string feature) {
+        return getFloat(internWC(feature));
+    }
+
+    double getFloatMin(std::string feature) {
+        return getFloatMin(internWC(feature));
+    }
+
+    double getFloatMax(std::string feature) {
+        return getFloatMax(internWC(feature));
+    }
+
+    void setFloat(std::string feature, double value) {
+        setFloat(internWC(feature), value);
+    }
+
+    int getEnumInt(std::string feature) {
+        return getEnumInt(internWC(feature));
+    }
+
+    void setEnumInt(std::string feature, int index) {
+        setEnumInt(internWC(feature), index);
+    }
+
+    std::string getEnum(std::string feature) {
+        return getEnum(internWC(feature));
+    }
+
+    std::string getString(std::string feature) {
+        return getString(internWC(feature));
+    }
+
+    void setEnum(std::string feature, std::string value) {
+        setEnum(internWC(feature), internWC(value));
+    }
+
+    void command(std::string feature) {
+        command(internWC(feature));
+    }
+
+    std::map<int, std::string> getEnumOptions(std::string feature) {
+        return getEnumOptions(internWC(feature));
+    }
+
     void queueBuffer(unsigned char buffer[], int bufferSize) { 
 
         int result = AT_QueueBuffer(handle, buffer, bufferSize);
@@ -905,42 +654,213 @@ class Zyla {
 
         int size;
         unsigned char* pointer = acquireRaw(timeout, &size);
-        unsigned char* output  = new unsigned char[2 * width * height];
+        unsigned short* output = new unsigned short[width * height];
 
-        int result = AT_ConvertBuffer(pointer, output, width, height, stride, stringToWC(enc), L"Mono16");
+        int result = AT_SUCCESS;
+
+        if (!convertToMono16(pointer, output, width, height, stride, encodingFromString(enc), size)) {
+            result = AT_ConvertBuffer(pointer, (unsigned char*) output, width, height, stride, internWC(enc), L"Mono16");
+        }
+
+        // The raw buffer was allocated by queueBuffer(), and isn't needed once converted
+        delete[] pointer;
 
         if (result != AT_SUCCESS) {
+            delete[] output;
             ostringstream oss;
             oss << "Acquiring Image: " << errorNames[result] << " (" << result << ")";
             throw oss.str();
         }
 
-        return Acquisition((unsigned short*) output, width, height);
+        return Acquisition(output, width, height);
         
     }
 
+    /// @brief Captures count frames in a single acquisition (Fixed cycle mode, with
+    /// FrameCount set to count), into buffers all queued up-front from one allocation.
+    /// The given number of threads convert them to Mono16 as they arrive. timeout is
+    /// how long to wait for each frame, in ms. The cycle mode and
+    /// frame count are put back as they were afterwards, even if it fails, but metadata
+    /// is left turned on, as that's where the timestamps come from.
+    Burst acquireBurst(long count, int timeout, int threads = 1) {
+
+        if (count < 1) {
+            throw std::string("Need at least one frame for a burst");
+        }
+
+        // The buffers are all queued at once, and the pool counts them in an int
+        if (count > INT_MAX) {
+            throw std::string("Can't capture more than ") + std::to_string(INT_MAX) + " frames in a burst";
+        }
+
+        // Whatever is capturing may be a copy of the pipeline, so ask the camera itself
+        if (getBool(L"CameraAcquiring")) {
+            throw std::string("Can't capture a burst while the camera is already acquiring");
+        }
+
+        setBool(L"MetadataEnable", true);
+        setBool(L"MetadataFrameInfo", true);
+        setBool(L"MetadataTimestamp", true);
+
+        long          width     = getAOIWidth();
+        long          height    = getAOIHeight();
+        long          stride    = getAOIStride();
+        long          size      = getImageSizeBytes();
+        long          clock     = getInt(L"TimestampClockFrequency");
+        std::string   enc       = getEnum(L"PixelEncoding");
+        PixelEncoding encoding  = encodingFromString(enc);
+        long          pixels    = width * height;
+
+        // Puts the cycle mode and frame count back however this returns
+        CycleGuard cycle(handle);
+
+        setEnum(L"CycleMode", L"Fixed");
+        setFrameCount(count);
+
+        BufferPool buffers;
+        buffers.allocate((int) count, size);
+
+        std::vector<unsigned char*> raw(count);
+
+        // Only handed over to the Burst once every frame has been captured
+        std::unique_ptr<unsigned short[]> output(new unsigned short[count * pixels]);
+        std::unique_ptr<long long[]>      timestamps(new long long[count]());
+
+        int result = AT_SUCCESS;
+
+        for (long i = 0; i < count && result == AT_SUCCESS; i++) {
+            raw[i] = buffers.tryAcquire();
+            result = AT_QueueBuffer(handle, raw[i], size);
+        }
+
+        // Frames are converted by the workers as soon as they've arrived, each taking every nth one
+        std::mutex              lock;
+        std::condition_variable arrived;
+        long                    received = 0;
+        bool                    started  = result == AT_SUCCESS;
+        bool                    failed   = !started;
+        bool                    mismatch = false;
+
+        threads = std::max(1, (int) std::min((long) threads, count));
+
+        std::vector<std::thread> workers;
+
+        for (int t = 0; t < threads; t++) {
+
+            workers.push_back(std::thread([&, t]() {
+
+                for (long i = t; i < count; i += threads) {
+
+                    {
+                        std::unique_lock<std::mutex> guard(lock);
+                        arrived.wait(guard, [&]() { return received > i || failed; });
+
+                        if (failed) {
+                            return;
+                        }
+                    }
+
+                    FrameMetadata metadata;
+
+                    if (parseMetadata(raw[i], size, metadata) && metadata.hasTimestamp) {
+                        timestamps[i] = metadata.timestamp;
+                    }
+
+                    unsigned short* frame = output.get() + i * pixels;
+
+                    if (!convertToMono16(raw[i], frame, width, height, stride, encoding, size)) {
+
+                        int code = AT_ConvertBuffer(raw[i], (unsigned char*) frame, width, height, stride, internWC(enc), L"Mono16");
+
+                        if (code != AT_SUCCESS) {
+                            std::lock_guard<std::mutex> guard(lock);
+                            result = code;
+                            failed = true;
+                            arrived.notify_all();
+                            return;
+                        }
+
+                    }
+
+                }
+
+            }));
+
+        }
+
+        if (started) {
+            AT_Command(handle, L"AcquisitionStart");
+        }
+
+        // Buffers come back in the order they were queued, so the nth one back is frame n
+        for (long i = 0; started && i < count; i++) {
+
+            unsigned char* buffer;
+            int            length;
+            int            code = AT_WaitBuffer(handle, &buffer, &length, timeout);
+
+            std::lock_guard<std::mutex> guard(lock);
+
+            // Anything other than the next buffer queued would mean the frames are out of step
+            if (code == AT_SUCCESS && buffer != raw[i]) {
+                mismatch = true;
+            }
+
+            if (code != AT_SUCCESS || failed || mismatch) {
+                result = failed ? result : code;
+                failed = true;
+                arrived.notify_all();
+                break;
+            }
+
+            received = i + 1;
+            arrived.notify_all();
+
+        }
+
+        for (std::thread& worker : workers) {
+            worker.join();
+        }
+
+        AT_Command(handle, L"AcquisitionStop");
+        AT_Flush(handle);
+
+        if (mismatch) {
+            throw std::string("Acquiring Burst: a frame came back in a buffer other than the one queued for it");
+        }
+
+        if (failed) {
+            ostringstream oss;
+            oss << "Acquiring Burst: " << errorNames[result] << " (" << result << ")";
+            throw oss.str();
+        }
+
+        return Burst(output.release(), timestamps.release(), count, width, height, clock);
+
+    }
+
     long getAccumulateCount() {
-        return getInt("AccumulateCount");
+        return getInt(L"AccumulateCount");
     }
 
     void setAccumulateCount(long value) {
-        setInt("AccumulateCount", value);
+        setInt(L"AccumulateCount", value);
     }
 
     long getAccumulateCountMin() {
-        return getIntMin("AccumulateCount");
+        return getIntMin(L"AccumulateCount");
     }
 
     long getAccumulateCountMax() {
-        return getIntMax("AccumulateCount");
+        return getIntMax(L"AccumulateCount");
     }
 
     void acquisitionStart() {
-        command("AcquisitionStart");
+        command(L"AcquisitionStart");
     }
 
     void acquisitionStop() {
-        command("AcquisitionStop");
+        command(L"AcquisitionStop");
     }
 
     void flush() {
@@ -956,691 +876,691 @@ class Zyla {
     }
 
     bool isAlternatingReadoutDirection() {
-        return getBool("AlternatingReadoutDirection");
+        return getBool(L"AlternatingReadoutDirection");
     }
 
     void setAlternatingReadoutDirection(bool value) {
-        setBool("AlternatingReadoutDirection", value);
+        setBool(L"AlternatingReadoutDirection", value);
     }
 
     int getAOIBinning() {
-        return getEnumInt("AOIBinning");
+        return getEnumInt(L"AOIBinning");
     }
 
     void setAOIBinning(int index) {
-        setEnumInt("AOIBinning", index);
+        setEnumInt(L"AOIBinning", index);
     }
 
     std::map<int, std::string> getAOIBinningOptions() {
-        return getEnumOptions("AOIBinning");
+        return getEnumOptions(L"AOIBinning");
     }
 
     long getAOIHBin() {
-        return getInt("AOIHBin");
+        return getInt(L"AOIHBin");
     }
 
     void setAOIHBin(long value) {
-        setInt("AOIHBin", value);
+        setInt(L"AOIHBin", value);
     }
 
     long getAOIHBinMin() {
-        return getIntMin("AOIHBin");
+        return getIntMin(L"AOIHBin");
     }
 
     long getAOIHBinMax() {
-        return getIntMax("AOIHBin");
+        return getIntMax(L"AOIHBin");
     }
 
     long getAOIHeight() {
-        return getInt("AOIHeight");
+        return getInt(L"AOIHeight");
     }
 
     void setAOIHeight(long value) {
-        setInt("AOIHeight", value);
+        setInt(L"AOIHeight", value);
     }
 
     long getAOIHeightMin() {
-        return getIntMin("AOIHeight");
+        return getIntMin(L"AOIHeight");
     }
 
     long getAOIHeightMax() {
-        return getIntMax("AOIHeight");
+        return getIntMax(L"AOIHeight");
     }
 
     int getAOILayout() {
-        return getEnumInt("AOILayout");
+        return getEnumInt(L"AOILayout");
     }
 
     void setAOILayout(int index) {
-        setEnumInt("AOILayout", index);
+        setEnumInt(L"AOILayout", index);
     }
 
     std::map<int, std::string> getAOILayoutOptions() {
-        return getEnumOptions("AOILayout");
+        return getEnumOptions(L"AOILayout");
     }
 
     long getAOILeft() {
-        return getInt("AOILeft");
+        return getInt(L"AOILeft");
     }
 
     void setAOILeft(long value) {
-        setInt("AOILeft", value);
+        setInt(L"AOILeft", value);
     }
 
     long getAOILeftMin() {
-        return getIntMin("AOILeft");
+        return getIntMin(L"AOILeft");
     }
 
     long getAOILeftMax() {
-        return getIntMax("AOILeft");
+        return getIntMax(L"AOILeft");
     }
 
     long getAOIStride() {
-        return getInt("AOIStride");
+        return getInt(L"AOIStride");
     }
 
     void setAOIStride(long value) {
-        setInt("AOIStride", value);
+        setInt(L"AOIStride", value);
     }
 
     long getAOIStrideMin() {
-        return getIntMin("AOIStride");
+        return getIntMin(L"AOIStride");
     }
 
     long getAOIStrideMax() {
-        return getIntMax("AOIStride");
+        return getIntMax(L"AOIStride");
     }
 
     long getAOITop() {
-        return getInt("AOITop");
+        return getInt(L"AOITop");
     }
 
     void setAOITop(long value) {
-        setInt("AOITop", value);
+        setInt(L"AOITop", value);
     }
 
     long getAOITopMin() {
-        return getIntMin("AOITop");
+        return getIntMin(L"AOITop");
     }
 
     long getAOITopMax() {
-        return getIntMax("AOITop");
+        return getIntMax(L"AOITop");
     }
 
     long getAOIVBin() {
-        return getInt("AOIVBin");
+        return getInt(L"AOIVBin");
     }
 
     void setAOIVBin(long value) {
-        setInt("AOIVBin", value);
+        setInt(L"AOIVBin", value);
     }
 
     long getAOIVBinMin() {
-        return getIntMin("AOIVBin");
+        return getIntMin(L"AOIVBin");
     }
 
     long getAOIVBinMax() {
-        return getIntMax("AOIVBin");
+        return getIntMax(L"AOIVBin");
     }
 
     long getAOIWidth() {
-        return getInt("AOIWidth");
+        return getInt(L"AOIWidth");
     }
 
     void setAOIWidth(long value) {
-        setInt("AOIWidth", value);
+        setInt(L"AOIWidth", value);
     }
 
     long getAOIWidthMin() {
-        return getIntMin("AOIWidth");
+        return getIntMin(L"AOIWidth");
     }
 
     long getAOIWidthMax() {
-        return getIntMax("AOIWidth");
+        return getIntMax(L"AOIWidth");
     }
 
     int getAuxiliaryOutSource() {
-        return getEnumInt("AuxiliaryOutSource");
+        return getEnumInt(L"AuxiliaryOutSource");
     }
 
     void setAuxiliaryOutSource(int index) {
-        setEnumInt("AuxiliaryOutSource", index);
+        setEnumInt(L"AuxiliaryOutSource", index);
     }
 
     std::map<int, std::string> getAuxiliaryOutSourceOptions() {
-        return getEnumOptions("AuxiliaryOutSource");
+        return getEnumOptions(L"AuxiliaryOutSource");
     }
 
     int getAuxOutSourceTwo() {
-        return getEnumInt("AuxOutSourceTwo");
+        return getEnumInt(L"AuxOutSourceTwo");
     }
 
     void setAuxOutSourceTwo(int index) {
-        setEnumInt("AuxOutSourceTwo", index);
+        setEnumInt(L"AuxOutSourceTwo", index);
     }
 
     std::map<int, std::string> getAuxOutSourceTwoOptions() {
-        return getEnumOptions("AuxOutSourceTwo");
+        return getEnumOptions(L"AuxOutSourceTwo");
     }
 
     long getBaseline() {
-        return getInt("Baseline");
+        return getInt(L"Baseline");
     }
 
     void setBaseline(long value) {
-        setInt("Baseline", value);
+        setInt(L"Baseline", value);
     }
 
     long getBaselineMin() {
-        return getIntMin("Baseline");
+        return getIntMin(L"Baseline");
     }
 
     long getBaselineMax() {
-        return getIntMax("Baseline");
+        return getIntMax(L"Baseline");
     }
 
     int getBitDepth() {
-        return getEnumInt("BitDepth");
+        return getEnumInt(L"BitDepth");
     }
 
     void setBitDepth(int index) {
-        setEnumInt("BitDepth", index);
+        setEnumInt(L"BitDepth", index);
     }
 
     std::map<int, std::string> getBitDepthOptions() {
-        return getEnumOptions("BitDepth");
+        return getEnumOptions(L"BitDepth");
     }
 
     long getBufferOverflowEvent() {
-        return getInt("BufferOverflowEvent");
+        return getInt(L"BufferOverflowEvent");
     }
 
     void setBufferOverflowEvent(long value) {
-        setInt("BufferOverflowEvent", value);
+        setInt(L"BufferOverflowEvent", value);
     }
 
     long getBufferOverflowEventMin() {
-        return getIntMin("BufferOverflowEvent");
+        return getIntMin(L"BufferOverflowEvent");
     }
 
     long getBufferOverflowEventMax() {
-        return getIntMax("BufferOverflowEvent");
+        return getIntMax(L"BufferOverflowEvent");
     }
 
     double getBytesPerPixel() {
-        return getFloat("BytesPerPixel");
+        return getFloat(L"BytesPerPixel");
     }
 
     void setBytesPerPixel(double value) {
-        setFloat("BytesPerPixel", value);
+        setFloat(L"BytesPerPixel", value);
     }
 
     double getBytesPerPixelMin() {
-        return getFloatMin("BytesPerPixel");
+        return getFloatMin(L"BytesPerPixel");
     }
 
     double getBytesPerPixelMax() {
-        return getFloatMax("BytesPerPixel");
+        return getFloatMax(L"BytesPerPixel");
     }
 
     bool isCameraAcquiring() {
-        return getBool("CameraAcquiring");
+        return getBool(L"CameraAcquiring");
     }
 
     void setCameraAcquiring(bool value) {
-        setBool("CameraAcquiring", value);
+        setBool(L"CameraAcquiring", value);
     }
 
     bool isCameraPresent() {
-        return getBool("CameraPresent");
+        return getBool(L"CameraPresent");
     }
 
     void setCameraPresent(bool value) {
-        setBool("CameraPresent", value);
+        setBool(L"CameraPresent", value);
     }
 
     std::string getControllerID() {
-        return getString("ControllerID");
+        return getString(L"ControllerID");
     }
 
     double getCoolerPower() {
-        return getFloat("CoolerPower");
+        return getFloat(L"CoolerPower");
     }
 
     void setCoolerPower(double value) {
-        setFloat("CoolerPower", value);
+        setFloat(L"CoolerPower", value);
     }
 
     double getCoolerPowerMin() {
-        return getFloatMin("CoolerPower");
+        return getFloatMin(L"CoolerPower");
     }
 
     double getCoolerPowerMax() {
-        return getFloatMax("CoolerPower");
+        return getFloatMax(L"CoolerPower");
     }
 
     int getCycleMode() {
-        return getEnumInt("CycleMode");
+        return getEnumInt(L"CycleMode");
     }
 
     void setCycleMode(int index) {
-        setEnumInt("CycleMode", index);
+        setEnumInt(L"CycleMode", index);
     }
 
     std::map<int, std::string> getCycleModeOptions() {
-        return getEnumOptions("CycleMode");
+        return getEnumOptions(L"CycleMode");
     }
 
     long getDeviceCount() {
-        return getInt("DeviceCount");
+        return getInt(L"DeviceCount");
     }
 
     void setDeviceCount(long value) {
-        setInt("DeviceCount", value);
+        setInt(L"DeviceCount", value);
     }
 
     long getDeviceCountMin() {
-        return getIntMin("DeviceCount");
+        return getIntMin(L"DeviceCount");
     }
 
     long getDeviceCountMax() {
-        return getIntMax("DeviceCount");
+        return getIntMax(L"DeviceCount");
     }
 
     long getDeviceVideoIndex() {
-        return getInt("DeviceVideoIndex");
+        return getInt(L"DeviceVideoIndex");
     }
 
     void setDeviceVideoIndex(long value) {
-        setInt("DeviceVideoIndex", value);
+        setInt(L"DeviceVideoIndex", value);
     }
 
     long getDeviceVideoIndexMin() {
-        return getIntMin("DeviceVideoIndex");
+        return getIntMin(L"DeviceVideoIndex");
     }
 
     long getDeviceVideoIndexMax() {
-        return getIntMax("DeviceVideoIndex");
+        return getIntMax(L"DeviceVideoIndex");
     }
 
     int getElectronicShutteringMode() {
-        return getEnumInt("ElectronicShutteringMode");
+        return getEnumInt(L"ElectronicShutteringMode");
     }
 
     void setElectronicShutteringMode(int index) {
-        setEnumInt("ElectronicShutteringMode", index);
+        setEnumInt(L"ElectronicShutteringMode", index);
     }
 
     std::map<int, std::string> getElectronicShutteringModeOptions() {
-        return getEnumOptions("ElectronicShutteringMode");
+        return getEnumOptions(L"ElectronicShutteringMode");
     }
 
     bool isEventEnable() {
-        return getBool("EventEnable");
+        return getBool(L"EventEnable");
     }
 
     void setEventEnable(bool value) {
-        setBool("EventEnable", value);
+        setBool(L"EventEnable", value);
     }
 
     int getEventSelector() {
-        return getEnumInt("EventSelector");
+        return getEnumInt(L"EventSelector");
     }
 
     void setEventSelector(int index) {
-        setEnumInt("EventSelector", index);
+        setEnumInt(L"EventSelector", index);
     }
 
     std::map<int, std::string> getEventSelectorOptions() {
-        return getEnumOptions("EventSelector");
+        return getEnumOptions(L"EventSelector");
     }
 
     long getEventsMissedEvent() {
-        return getInt("EventsMissedEvent");
+        return getInt(L"EventsMissedEvent");
     }
 
     void setEventsMissedEvent(long value) {
-        setInt("EventsMissedEvent", value);
+        setInt(L"EventsMissedEvent", value);
     }
 
     long getEventsMissedEventMin() {
-        return getIntMin("EventsMissedEvent");
+        return getIntMin(L"EventsMissedEvent");
     }
 
     long getEventsMissedEventMax() {
-        return getIntMax("EventsMissedEvent");
+        return getIntMax(L"EventsMissedEvent");
     }
 
     long getExposedPixelHeight() {
-        return getInt("ExposedPixelHeight");
+        return getInt(L"ExposedPixelHeight");
     }
 
     void setExposedPixelHeight(long value) {
-        setInt("ExposedPixelHeight", value);
+        setInt(L"ExposedPixelHeight", value);
     }
 
     long getExposedPixelHeightMin() {
-        return getIntMin("ExposedPixelHeight");
+        return getIntMin(L"ExposedPixelHeight");
     }
 
     long getExposedPixelHeightMax() {
-        return getIntMax("ExposedPixelHeight");
+        return getIntMax(L"ExposedPixelHeight");
     }
 
     long getExposureEndEvent() {
-        return getInt("ExposureEndEvent");
+        return getInt(L"ExposureEndEvent");
     }
 
     void setExposureEndEvent(long value) {
-        setInt("ExposureEndEvent", value);
+        setInt(L"ExposureEndEvent", value);
     }
 
     long getExposureEndEventMin() {
-        return getIntMin("ExposureEndEvent");
+        return getIntMin(L"ExposureEndEvent");
     }
 
     long getExposureEndEventMax() {
-        return getIntMax("ExposureEndEvent");
+        return getIntMax(L"ExposureEndEvent");
     }
 
     long getExposureStartEvent() {
-        return getInt("ExposureStartEvent");
+        return getInt(L"ExposureStartEvent");
     }
 
     void setExposureStartEvent(long value) {
-        setInt("ExposureStartEvent", value);
+        setInt(L"ExposureStartEvent", value);
     }
 
     long getExposureStartEventMin() {
-        return getIntMin("ExposureStartEvent");
+        return getIntMin(L"ExposureStartEvent");
     }
 
     long getExposureStartEventMax() {
-        return getIntMax("ExposureStartEvent");
+        return getIntMax(L"ExposureStartEvent");
     }
 
     double getExposureTime() {
-        return getFloat("ExposureTime");
+        return getFloat(L"ExposureTime");
     }
 
     void setExposureTime(double value) {
-        setFloat("ExposureTime", value);
+        setFloat(L"ExposureTime", value);
     }
 
     double getExposureTimeMin() {
-        return getFloatMin("ExposureTime");
+        return getFloatMin(L"ExposureTime");
     }
 
     double getExposureTimeMax() {
-        return getFloatMax("ExposureTime");
+        return getFloatMax(L"ExposureTime");
     }
 
     double getExternalTriggerDelay() {
-        return getFloat("ExternalTriggerDelay");
+        return getFloat(L"ExternalTriggerDelay");
     }
 
     void setExternalTriggerDelay(double value) {
-        setFloat("ExternalTriggerDelay", value);
+        setFloat(L"ExternalTriggerDelay", value);
     }
 
     double getExternalTriggerDelayMin() {
-        return getFloatMin("ExternalTriggerDelay");
+        return getFloatMin(L"ExternalTriggerDelay");
     }
 
     double getExternalTriggerDelayMax() {
-        return getFloatMax("ExternalTriggerDelay");
+        return getFloatMax(L"ExternalTriggerDelay");
     }
 
     int getFanSpeed() {
-        return getEnumInt("FanSpeed");
+        return getEnumInt(L"FanSpeed");
     }
 
     void setFanSpeed(int index) {
-        setEnumInt("FanSpeed", index);
+        setEnumInt(L"FanSpeed", index);
     }
 
     std::map<int, std::string> getFanSpeedOptions() {
-        return getEnumOptions("FanSpeed");
+        return getEnumOptions(L"FanSpeed");
     }
 
     bool isFastAOIFrameRateEnable() {
-        return getBool("FastAOIFrameRateEnable");
+        return getBool(L"FastAOIFrameRateEnable");
     }
 
     void setFastAOIFrameRateEnable(bool value) {
-        setBool("FastAOIFrameRateEnable", value);
+        setBool(L"FastAOIFrameRateEnable", value);
     }
 
     long getFrameCount() {
-        return getInt("FrameCount");
+        return getInt(L"FrameCount");
     }
 
     void setFrameCount(long value) {
-        setInt("FrameCount", value);
+        setInt(L"FrameCount", value);
     }
 
     long getFrameCountMin() {
-        return getIntMin("FrameCount");
+        return getIntMin(L"FrameCount");
     }
 
     long getFrameCountMax() {
-        return getIntMax("FrameCount");
+        return getIntMax(L"FrameCount");
     }
 
     double getFrameRate() {
-        return getFloat("FrameRate");
+        return getFloat(L"FrameRate");
     }
 
     void setFrameRate(double value) {
-        setFloat("FrameRate", value);
+        setFloat(L"FrameRate", value);
     }
 
     double getFrameRateMin() {
-        return getFloatMin("FrameRate");
+        return getFloatMin(L"FrameRate");
     }
 
     double getFrameRateMax() {
-        return getFloatMax("FrameRate");
+        return getFloatMax(L"FrameRate");
     }
 
     bool isFullAOIControl() {
-        return getBool("FullAOIControl");
+        return getBool(L"FullAOIControl");
     }
 
     void setFullAOIControl(bool value) {
-        setBool("FullAOIControl", value);
+        setBool(L"FullAOIControl", value);
     }
 
     long getImageSizeBytes() {
-        return getInt("ImageSizeBytes");
+        return getInt(L"ImageSizeBytes");
     }
 
     void setImageSizeBytes(long value) {
-        setInt("ImageSizeBytes", value);
+        setInt(L"ImageSizeBytes", value);
     }
 
     long getImageSizeBytesMin() {
-        return getIntMin("ImageSizeBytes");
+        return getIntMin(L"ImageSizeBytes");
     }
 
     long getImageSizeBytesMax() {
-        return getIntMax("ImageSizeBytes");
+        return getIntMax(L"ImageSizeBytes");
     }
 
     bool isIOInvert() {
-        return getBool("IOInvert");
+        return getBool(L"IOInvert");
     }
 
     void setIOInvert(bool value) {
-        setBool("IOInvert", value);
+        setBool(L"IOInvert", value);
     }
 
     int getIOSelector() {
-        return getEnumInt("IOSelector");
+        return getEnumInt(L"IOSelector");
     }
 
     void setIOSelector(int index) {
-        setEnumInt("IOSelector", index);
+        setEnumInt(L"IOSelector", index);
     }
 
     std::map<int, std::string> getIOSelectorOptions() {
-        return getEnumOptions("IOSelector");
+        return getEnumOptions(L"IOSelector");
     }
 
     double getLineScanSpeed() {
-        return getFloat("LineScanSpeed");
+        return getFloat(L"LineScanSpeed");
     }
 
     void setLineScanSpeed(double value) {
-        setFloat("LineScanSpeed", value);
+        setFloat(L"LineScanSpeed", value);
     }
 
     double getLineScanSpeedMin() {
-        return getFloatMin("LineScanSpeed");
+        return getFloatMin(L"LineScanSpeed");
     }
 
     double getLineScanSpeedMax() {
-        return getFloatMax("LineScanSpeed");
+        return getFloatMax(L"LineScanSpeed");
     }
 
     int getLogLevel() {
-        return getEnumInt("LogLevel");
+        return getEnumInt(L"LogLevel");
     }
 
     void setLogLevel(int index) {
-        setEnumInt("LogLevel", index);
+        setEnumInt(L"LogLevel", index);
     }
 
     std::map<int, std::string> getLogLevelOptions() {
-        return getEnumOptions("LogLevel");
+        return getEnumOptions(L"LogLevel");
     }
 
     double getLongExposureTransition() {
-        return getFloat("LongExposureTransition");
+        return getFloat(L"LongExposureTransition");
     }
 
     void setLongExposureTransition(double value) {
-        setFloat("LongExposureTransition", value);
+        setFloat(L"LongExposureTransition", value);
     }
 
     double getLongExposureTransitionMin() {
-        return getFloatMin("LongExposureTransition");
+        return getFloatMin(L"LongExposureTransition");
     }
 
     double getLongExposureTransitionMax() {
-        return getFloatMax("LongExposureTransition");
+        return getFloatMax(L"LongExposureTransition");
     }
 
     double getMaxInterfaceTransferRate() {
-        return getFloat("MaxInterfaceTransferRate");
+        return getFloat(L"MaxInterfaceTransferRate");
     }
 
     void setMaxInterfaceTransferRate(double value) {
-        setFloat("MaxInterfaceTransferRate", value);
+        setFloat(L"MaxInterfaceTransferRate", value);
     }
 
     double getMaxInterfaceTransferRateMin() {
-        return getFloatMin("MaxInterfaceTransferRate");
+        return getFloatMin(L"MaxInterfaceTransferRate");
     }
 
     double getMaxInterfaceTransferRateMax() {
-        return getFloatMax("MaxInterfaceTransferRate");
+        return getFloatMax(L"MaxInterfaceTransferRate");
     }
 
     bool isMetadataEnable() {
-        return getBool("MetadataEnable");
+        return getBool(L"MetadataEnable");
     }
 
     void setMetadataEnable(bool value) {
-        setBool("MetadataEnable", value);
+        setBool(L"MetadataEnable", value);
     }
 
     bool isMetadataFrame() {
-        return getBool("MetadataFrame");
+        return getBool(L"MetadataFrame");
     }
 
     void setMetadataFrame(bool value) {
-        setBool("MetadataFrame", value);
+        setBool(L"MetadataFrame", value);
     }
 
     bool isMetadataTimestamp() {
-        return getBool("MetadataTimestamp");
+        return getBool(L"MetadataTimestamp");
     }
 
     void setMetadataTimestamp(bool value) {
-        setBool("MetadataTimestamp", value);
+        setBool(L"MetadataTimestamp", value);
     }
 
     bool isMultitrackBinned() {
-        return getBool("MultitrackBinned");
+        return getBool(L"MultitrackBinned");
     }
 
     void setMultitrackBinned(bool value) {
-        setBool("MultitrackBinned", value);
+        setBool(L"MultitrackBinned", value);
     }
 
     long getMultitrackCount() {
-        return getInt("MultitrackCount");
+        return getInt(L"MultitrackCount");
     }
 
     void setMultitrackCount(long value) {
-        setInt("MultitrackCount", value);
+        setInt(L"MultitrackCount", value);
     }
 
     long getMultitrackCountMin() {
-        return getIntMin("MultitrackCount");
+        return getIntMin(L"MultitrackCount");
     }
 
     long getMultitrackCountMax() {
-        return getIntMax("MultitrackCount");
+        return getIntMax(L"MultitrackCount");
     }
 
     long getMultitrackEnd() {
-        return getInt("MultitrackEnd");
+        return getInt(L"MultitrackEnd");
     }
 
     void setMultitrackEnd(long value) {
-        setInt("MultitrackEnd", value);
+        setInt(L"MultitrackEnd", value);
     }
 
     long getMultitrackEndMin() {
-        return getIntMin("MultitrackEnd");
+        return getIntMin(L"MultitrackEnd");
     }
 
     long getMultitrackEndMax() {
-        return getIntMax("MultitrackEnd");
+        return getIntMax(L"MultitrackEnd");
     }
 
     long getMultitrackSelector() {
-        return getInt("MultitrackSelector");
+        return getInt(L"MultitrackSelector");
     }
 
     void setMultitrackSelector(long value) {
-        setInt("MultitrackSelector", value);
+        setInt(L"MultitrackSelector", value);
     }
 
     long getMultitrackSelectorMin() {
-        return getIntMin("MultitrackSelector");
+        return getIntMin(L"MultitrackSelector");
     }
 
     long getMultitrackSelectorMax() {
-        return getIntMax("MultitrackSelector");
+        return getIntMax(L"MultitrackSelector");
     }
 
     long getMultitrackStart() {
-        return getInt("MultitrackStart");
+        return getInt(L"MultitrackStart");
     }
 
     void setMultitrackStart(long value) {
-        setInt("MultitrackStart", value);
+        setInt(L"MultitrackStart", value);
     }
 
     long getMultitrackStartMin() {
-        return getIntMin("MultitrackStart");
+        return getIntMin(L"MultitrackStart");
     }
 
     long getMultitrackStartMax() {
-        return getIntMax("MultitrackStart");
+        return getIntMax(L"MultitrackStart");
     }
 
     std::vector<Track> getTracks() {
@@ -1679,359 +1599,359 @@ class Zyla {
     }
 
     bool isOverlap() {
-        return getBool("Overlap");
+        return getBool(L"Overlap");
     }
 
     void setOverlap(bool value) {
-        setBool("Overlap", value);
+        setBool(L"Overlap", value);
     }
 
     int getPixelEncoding() {
-        return getEnumInt("PixelEncoding");
+        return getEnumInt(L"PixelEncoding");
     }
 
     void setPixelEncoding(int index) {
-        setEnumInt("PixelEncoding", index);
+        setEnumInt(L"PixelEncoding", index);
     }
 
     std::map<int, std::string> getPixelEncodingOptions() {
-        return getEnumOptions("PixelEncoding");
+        return getEnumOptions(L"PixelEncoding");
     }
 
     double getPixelHeight() {
-        return getFloat("PixelHeight");
+        return getFloat(L"PixelHeight");
     }
 
     void setPixelHeight(double value) {
-        setFloat("PixelHeight", value);
+        setFloat(L"PixelHeight", value);
     }
 
     double getPixelHeightMin() {
-        return getFloatMin("PixelHeight");
+        return getFloatMin(L"PixelHeight");
     }
 
     double getPixelHeightMax() {
-        return getFloatMax("PixelHeight");
+        return getFloatMax(L"PixelHeight");
     }
 
     int getPixelReadoutRate() {
-        return getEnumInt("PixelReadoutRate");
+        return getEnumInt(L"PixelReadoutRate");
     }
 
     void setPixelReadoutRate(int index) {
-        setEnumInt("PixelReadoutRate", index);
+        setEnumInt(L"PixelReadoutRate", index);
     }
 
     std::map<int, std::string> getPixelReadoutRateOptions() {
-        return getEnumOptions("PixelReadoutRate");
+        return getEnumOptions(L"PixelReadoutRate");
     }
 
     double getPixelWidth() {
-        return getFloat("PixelWidth");
+        return getFloat(L"PixelWidth");
     }
 
     void setPixelWidth(double value) {
-        setFloat("PixelWidth", value);
+        setFloat(L"PixelWidth", value);
     }
 
     double getPixelWidthMin() {
-        return getFloatMin("PixelWidth");
+        return getFloatMin(L"PixelWidth");
     }
 
     double getPixelWidthMax() {
-        return getFloatMax("PixelWidth");
+        return getFloatMax(L"PixelWidth");
     }
 
     double getReadoutTime() {
-        return getFloat("ReadoutTime");
+        return getFloat(L"ReadoutTime");
     }
 
     void setReadoutTime(double value) {
-        setFloat("ReadoutTime", value);
+        setFloat(L"ReadoutTime", value);
     }
 
     double getReadoutTimeMin() {
-        return getFloatMin("ReadoutTime");
+        return getFloatMin(L"ReadoutTime");
     }
 
     double getReadoutTimeMax() {
-        return getFloatMax("ReadoutTime");
+        return getFloatMax(L"ReadoutTime");
     }
 
     bool isRollingShutterGlobalClear() {
-        return getBool("RollingShutterGlobalClear");
+        return getBool(L"RollingShutterGlobalClear");
     }
 
     void setRollingShutterGlobalClear(bool value) {
-        setBool("RollingShutterGlobalClear", value);
+        setBool(L"RollingShutterGlobalClear", value);
     }
 
     long getRowNExposureEndEvent() {
-        return getInt("RowNExposureEndEvent");
+        return getInt(L"RowNExposureEndEvent");
     }
 
     void setRowNExposureEndEvent(long value) {
-        setInt("RowNExposureEndEvent", value);
+        setInt(L"RowNExposureEndEvent", value);
     }
 
     long getRowNExposureEndEventMin() {
-        return getIntMin("RowNExposureEndEvent");
+        return getIntMin(L"RowNExposureEndEvent");
     }
 
     long getRowNExposureEndEventMax() {
-        return getIntMax("RowNExposureEndEvent");
+        return getIntMax(L"RowNExposureEndEvent");
     }
 
     long getRowNExposureStartEvent() {
-        return getInt("RowNExposureStartEvent");
+        return getInt(L"RowNExposureStartEvent");
     }
 
     void setRowNExposureStartEvent(long value) {
-        setInt("RowNExposureStartEvent", value);
+        setInt(L"RowNExposureStartEvent", value);
     }
 
     long getRowNExposureStartEventMin() {
-        return getIntMin("RowNExposureStartEvent");
+        return getIntMin(L"RowNExposureStartEvent");
     }
 
     long getRowNExposureStartEventMax() {
-        return getIntMax("RowNExposureStartEvent");
+        return getIntMax(L"RowNExposureStartEvent");
     }
 
     bool isScanSpeedControlEnable() {
-        return getBool("ScanSpeedControlEnable");
+        return getBool(L"ScanSpeedControlEnable");
     }
 
     void setScanSpeedControlEnable(bool value) {
-        setBool("ScanSpeedControlEnable", value);
+        setBool(L"ScanSpeedControlEnable", value);
     }
 
     bool isSensorCooling() {
-        return getBool("SensorCooling");
+        return getBool(L"SensorCooling");
     }
 
     void setSensorCooling(bool value) {
-        setBool("SensorCooling", value);
+        setBool(L"SensorCooling", value);
     }
 
     long getSensorHeight() {
-        return getInt("SensorHeight");
+        return getInt(L"SensorHeight");
     }
 
     void setSensorHeight(long value) {
-        setInt("SensorHeight", value);
+        setInt(L"SensorHeight", value);
     }
 
     long getSensorHeightMin() {
-        return getIntMin("SensorHeight");
+        return getIntMin(L"SensorHeight");
     }
 
     long getSensorHeightMax() {
-        return getIntMax("SensorHeight");
+        return getIntMax(L"SensorHeight");
     }
 
     int getSensorReadoutMode() {
-        return getEnumInt("SensorReadoutMode");
+        return getEnumInt(L"SensorReadoutMode");
     }
 
     void setSensorReadoutMode(int index) {
-        setEnumInt("SensorReadoutMode", index);
+        setEnumInt(L"SensorReadoutMode", index);
     }
 
     std::map<int, std::string> getSensorReadoutModeOptions() {
-        return getEnumOptions("SensorReadoutMode");
+        return getEnumOptions(L"SensorReadoutMode");
     }
 
     double getSensorTemperature() {
-        return getFloat("SensorTemperature");
+        return getFloat(L"SensorTemperature");
     }
 
     void setSensorTemperature(double value) {
-        setFloat("SensorTemperature", value);
+        setFloat(L"SensorTemperature", value);
     }
 
     double getSensorTemperatureMin() {
-        return getFloatMin("SensorTemperature");
+        return getFloatMin(L"SensorTemperature");
     }
 
     double getSensorTemperatureMax() {
-        return getFloatMax("SensorTemperature");
+        return getFloatMax(L"SensorTemperature");
     }
 
     long getSensorWidth() {
-        return getInt("SensorWidth");
+        return getInt(L"SensorWidth");
     }
 
     void setSensorWidth(long value) {
-        setInt("SensorWidth", value);
+        setInt(L"SensorWidth", value);
     }
 
     long getSensorWidthMin() {
-        return getIntMin("SensorWidth");
+        return getIntMin(L"SensorWidth");
     }
 
     long getSensorWidthMax() {
-        return getIntMax("SensorWidth");
+        return getIntMax(L"SensorWidth");
     }
 
     std::string getSerialNumber() {
-        return getString("SerialNumber");
+        return getString(L"SerialNumber");
     }
 
     int getShutterMode() {
-        return getEnumInt("ShutterMode");
+        return getEnumInt(L"ShutterMode");
     }
 
     void setShutterMode(int index) {
-        setEnumInt("ShutterMode", index);
+        setEnumInt(L"ShutterMode", index);
     }
 
     std::map<int, std::string> getShutterModeOptions() {
-        return getEnumOptions("ShutterMode");
+        return getEnumOptions(L"ShutterMode");
     }
 
     int getShutterOutputMode() {
-        return getEnumInt("ShutterOutputMode");
+        return getEnumInt(L"ShutterOutputMode");
     }
 
     void setShutterOutputMode(int index) {
-        setEnumInt("ShutterOutputMode", index);
+        setEnumInt(L"ShutterOutputMode", index);
     }
 
     std::map<int, std::string> getShutterOutputModeOptions() {
-        return getEnumOptions("ShutterOutputMode");
+        return getEnumOptions(L"ShutterOutputMode");
     }
 
     double getShutterTransferTime() {
-        return getFloat("ShutterTransferTime");
+        return getFloat(L"ShutterTransferTime");
     }
 
     void setShutterTransferTime(double value) {
-        setFloat("ShutterTransferTime", value);
+        setFloat(L"ShutterTransferTime", value);
     }
 
     double getShutterTransferTimeMin() {
-        return getFloatMin("ShutterTransferTime");
+        return getFloatMin(L"ShutterTransferTime");
     }
 
     double getShutterTransferTimeMax() {
-        return getFloatMax("ShutterTransferTime");
+        return getFloatMax(L"ShutterTransferTime");
     }
 
     int getSimplePreAmpGainControl() {
-        return getEnumInt("SimplePreAmpGainControl");
+        return getEnumInt(L"SimplePreAmpGainControl");
     }
 
     void setSimplePreAmpGainControl(int index) {
-        setEnumInt("SimplePreAmpGainControl", index);
+        setEnumInt(L"SimplePreAmpGainControl", index);
     }
 
     std::map<int, std::string> getSimplePreAmpGainControlOptions() {
-        return getEnumOptions("SimplePreAmpGainControl");
+        return getEnumOptions(L"SimplePreAmpGainControl");
     }
 
     void softwareTrigger() {
-        command("SoftwareTrigger");
+        command(L"SoftwareTrigger");
     }
 
     std::string getSoftwareVersion() {
-        return getString("SoftwareVersion");
+        return getString(L"SoftwareVersion");
     }
 
     bool isSpuriousNoiseFilter() {
-        return getBool("SpuriousNoiseFilter");
+        return getBool(L"SpuriousNoiseFilter");
     }
 
     void setSpuriousNoiseFilter(bool value) {
-        setBool("SpuriousNoiseFilter", value);
+        setBool(L"SpuriousNoiseFilter", value);
     }
 
     bool isStaticBlemishCorrection() {
-        return getBool("StaticBlemishCorrection");
+        return getBool(L"StaticBlemishCorrection");
     }
 
     void setStaticBlemishCorrection(bool value) {
-        setBool("StaticBlemishCorrection", value);
+        setBool(L"StaticBlemishCorrection", value);
     }
 
     int getTemperatureControl() {
-        return getEnumInt("TemperatureControl");
+        return getEnumInt(L"TemperatureControl");
     }
 
     void setTemperatureControl(int index) {
-        setEnumInt("TemperatureControl", index);
+        setEnumInt(L"TemperatureControl", index);
     }
 
     std::map<int, std::string> getTemperatureControlOptions() {
-        return getEnumOptions("TemperatureControl");
+        return getEnumOptions(L"TemperatureControl");
     }
 
     int getTemperatureStatus() {
-        return getEnumInt("TemperatureStatus");
+        return getEnumInt(L"TemperatureStatus");
     }
 
     void setTemperatureStatus(int index) {
-        setEnumInt("TemperatureStatus", index);
+        setEnumInt(L"TemperatureStatus", index);
     }
 
     std::map<int, std::string> getTemperatureStatusOptions() {
-        return getEnumOptions("TemperatureStatus");
+        return getEnumOptions(L"TemperatureStatus");
     }
 
     long getTimestampClock() {
-        return getInt("TimestampClock");
+        return getInt(L"TimestampClock");
     }
 
     void setTimestampClock(long value) {
-        setInt("TimestampClock", value);
+        setInt(L"TimestampClock", value);
     }
 
     long getTimestampClockMin() {
-        return getIntMin("TimestampClock");
+        return getIntMin(L"TimestampClock");
     }
 
     long getTimestampClockMax() {
-        return getIntMax("TimestampClock");
+        return getIntMax(L"TimestampClock");
     }
 
     long getTimestampClockFrequency() {
-        return getInt("TimestampClockFrequency");
+        return getInt(L"TimestampClockFrequency");
     }
 
     void setTimestampClockFrequency(long value) {
-        setInt("TimestampClockFrequency", value);
+        setInt(L"TimestampClockFrequency", value);
     }
 
     long getTimestampClockFrequencyMin() {
-        return getIntMin("TimestampClockFrequency");
+        return getIntMin(L"TimestampClockFrequency");
     }
 
     long getTimestampClockFrequencyMax() {
-        return getIntMax("TimestampClockFrequency");
+        return getIntMax(L"TimestampClockFrequency");
     }
 
     void timestampClockReset() {
-        command("TimestampClockReset");
+        command(L"TimestampClockReset");
     }
 
     int getTriggerMode() {
-        return getEnumInt("TriggerMode");
+        return getEnumInt(L"TriggerMode");
     }
 
     void setTriggerMode(int index) {
-        setEnumInt("TriggerMode", index);
+        setEnumInt(L"TriggerMode", index);
     }
 
     std::map<int, std::string> getTriggerModeOptions() {
-        return getEnumOptions("TriggerMode");
+        return getEnumOptions(L"TriggerMode");
     }
 
     bool isVerticallyCentreAOI() {
-        return getBool("VerticallyCentreAOI");
+        return getBool(L"VerticallyCentreAOI");
     }
 
     void setVerticallyCentreAOI(bool value) {
-        setBool("VerticallyCentreAOI", value);
+        setBool(L"VerticallyCentreAOI", value);
     }
     
 };
\ No newline at end of file
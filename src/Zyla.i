@@ -1,4 +1,7 @@
-%module PyZyla
+// Every call into C++ gives up the GIL while it runs, since most of them can block
+// on the SDK (feature access, waiting for buffers) or on the pipeline's threads
+// (A3C::stop() joins them), and other Python threads should carry on meanwhile
+%module(threads="1") PyZyla
 %include std_string.i
 %include std_map.i
 %include stdint.i
@@ -9,7 +12,51 @@
 %}
 %{
 #include "Zyla.cpp"
+#define NPY_NO_DEPRECATED_API NPY_1_7_API_VERSION
+#include <numpy/arrayobject.h>
+
+/// @brief Wraps data in a NumPy array of the given shape and type without copying
+/// it. The array holds its own reference to the data (in a capsule set as its
+/// base), so it lives for as long as the array, or any view of it, does.
+PyObject* sharedArray(std::shared_ptr<void> data, std::vector<npy_intp> dims, int type) {
+
+    typedef std::shared_ptr<void> Pixels;
+
+    Pixels* owner = new Pixels(data);
+
+    PyObject* capsule = PyCapsule_New(owner, "PyZyla.pixels", [](PyObject* object) {
+        delete (Pixels*) PyCapsule_GetPointer(object, "PyZyla.pixels");
+    });
+
+    if (capsule == nullptr) {
+        delete owner;
+        return nullptr;
+    }
+
+    PyObject* array = PyArray_SimpleNewFromData((int) dims.size(), dims.data(), type, owner->get());
+
+    if (array == nullptr) {
+        Py_DECREF(capsule);
+        return nullptr;
+    }
+
+    // Steals the reference to the capsule, even if it fails
+    if (PyArray_SetBaseObject((PyArrayObject*) array, capsule) < 0) {
+        Py_DECREF(array);
+        return nullptr;
+    }
+
+    return array;
+
+}
+
+PyObject* sharedArray(std::shared_ptr<void> pixels, long height, long width, int type) {
+    return sharedArray(pixels, std::vector<npy_intp> {(npy_intp) height, (npy_intp) width}, type);
+}
 %}    
+%init %{
+    import_array();
+%}
 %exception { 
     try {
         $action
@@ -39,8 +86,114 @@ public:
 
     void setOutputPath(std::string path);
 
+    void setPoolSize(int size);
+
+    void setQueueDepth(int depth);
+
+    void setDiskBandwidth(double mbPerSecond);
+
+    void setProcessThreads(int count);
+
+    void setNativeConversion(bool flag);
+
+    bool setWriterBackend(std::string backend);
+
+    bool setOutputFormat(std::string format);
+
+    bool setCompression(std::string scheme);
+
+    void setTrackBinning(bool flag);
+
+    void loadDark(std::string path);
+
+    void loadFlat(std::string path);
+
+    void buildDark(int frames);
+
+    void buildFlat(int frames);
+
+    void saveDark(std::string path);
+
+    void saveFlat(std::string path);
+
+    void clearDark();
+
+    void clearFlat();
+
+    bool setCorrectedEncoding(std::string name);
+
+    void setCoaddFrames(long frames);
+
+    void setCoaddStride(long frames);
+
+    void setSegmentFrames(long frames);
+
+    void setSegmentBytes(long bytes);
+
+    void setSegmentSeconds(double seconds);
+
     int getFrameLimit();
 
+    int getPoolSize();
+
+    int getQueueDepth();
+
+    int getProcessThreads();
+
+    bool isNativeConversion();
+
+    std::string getConversionKernel();
+
+    std::string getWriterBackend();
+
+    std::string getOutputFormat();
+
+    std::string getCompression();
+
+    bool isCompressing();
+
+    bool isTrackBinning();
+
+    bool isBinningTracks();
+
+    long getTrackCount();
+
+    bool hasDark();
+
+    bool hasFlat();
+
+    bool isCorrecting();
+
+    std::string getCorrectedEncoding();
+
+    long getCoaddFrames();
+
+    long getCoaddStride();
+
+    bool isCoadding();
+
+    void setStreamInterval(long frames);
+
+    void setStreamDepth(long frames);
+
+    long getStreamInterval();
+
+    long getStreamDepth();
+
+    StreamFrame nextFrame(long timeout);
+
+    bool isStreaming();
+
+    long getStreamDropped();
+
+    long getSegmentFrames();
+
+    long getSegmentBytes();
+
+    double getSegmentSeconds();
+
+    bool isSegmented();
+
     std::string getOutputPath();
 
     void start();
@@ -53,15 +206,128 @@ public:
 
     long getWriteFPS();
 
+    double getWriteRate();
+
+    double getCompressionRatio();
+
+    double getCompressionRate();
+
+    double getDiskBandwidth();
+
+    long getSegmentCount();
+
+    long getWrittenBytes();
+
     long getProcessQueueSize();
 
     long getWriteQueueSize();
 
+    long getWorkerFPS(int index);
+
+    long getReorderDepth();
+
+    long getDroppedFrames();
+
+    long getLateFrames();
+
+    long getTimestampDiscontinuities();
+
+    long getProcessQueueHighWatermark();
+
+    long getWriteQueueHighWatermark();
+
+    long getPoolInUse();
+
+    long getPoolStalls();
+
     long getAcquireCount();
 
     bool isRunning();
 
     bool isMonitoring();
+
+    %pythoncode %{
+
+        def frames(self, timeout=1000):
+            """Yields the frames copied out while capturing (see setStreamInterval),
+            until capturing has stopped and every one has been taken."""
+
+            while True:
+
+                frame = self.nextFrame(timeout)
+
+                if frame.isValid():
+                    yield frame
+                elif not self.isStreaming():
+                    return
+
+        def streamTo(self, callback, timeout=1000):
+            """Calls callback with each frame copied out while capturing, on a thread
+            of its own, which is returned. Call this after start(), as the thread
+            finishes once capturing has stopped and every frame has been taken."""
+
+            from threading import Thread
+
+            def run():
+                for frame in self.frames(timeout):
+                    callback(frame)
+
+            thread = Thread(target=run, daemon=True)
+            thread.start()
+
+            return thread
+
+    %}
+};
+
+class StreamFrame {
+
+    public:
+
+    StreamFrame();
+
+    bool isValid();
+
+    long getSequence();
+
+    long long getTimestamp();
+
+    double getTime();
+
+    int getStatus();
+
+    long getWidth();
+
+    long getHeight();
+
+    std::string getEncoding();
+
+    %pythoncode %{
+
+        def numpy(self):
+            """The pixels as a height x width array (uint16, uint32 totals or float32,
+            depending on the encoding), sharing memory with this frame."""
+            return self.array()
+
+    %}
+
+};
+
+// Builds a Python object, so needs to keep hold of the GIL
+%nothread StreamFrame::array;
+
+%extend StreamFrame {
+
+    /// @brief Wraps the pixels in a NumPy array without copying them.
+    PyObject* array() {
+
+        std::string encoding = $self->getEncoding();
+        int         type     = encoding == "Mono32" ? NPY_UINT32 : encoding == "Float32" ? NPY_FLOAT32 : NPY_UINT16;
+
+        return sharedArray($self->share(), $self->getHeight(), $self->getWidth(), type);
+
+    }
+
 };
 
 class Track {
@@ -113,14 +379,81 @@ class Acquisition {
     %pythoncode %{
 
         def numpy(self):
-
-            import numpy as np
-            return np.reshape(self.getArray(), (self.getHeight(), self.getWidth()))
+            """The pixels as a height x width uint16 array, sharing memory with this
+            acquisition (and any copies of it) rather than copying them."""
+            return self.array()
 
     %}
     
 };
 
+// Builds a Python object, so needs to keep hold of the GIL
+%nothread Acquisition::array;
+
+%extend Acquisition {
+
+    /// @brief Wraps the pixels in a NumPy array without copying them, which stays
+    /// valid after the Acquisition itself has been garbage collected.
+    PyObject* array() {
+        return sharedArray($self->share(), $self->getHeight(), $self->getWidth(), NPY_UINT16);
+    }
+
+};
+
+class Burst {
+
+    public:
+
+    long getCount();
+
+    long getWidth();
+
+    long getHeight();
+
+    long getClockFrequency();
+
+    long long getTimestamp(long frame);
+
+    double getTime(long frame);
+
+    unsigned short getPixel(long frame, int row, int column);
+
+    %pythoncode %{
+
+        def numpy(self):
+            """The pixels as a count x height x width uint16 array, sharing memory with
+            this burst rather than copying them."""
+            return self.array()
+
+        def timestamps(self):
+            """Hardware timestamp of each frame, in seconds."""
+            frequency = self.getClockFrequency()
+            if frequency <= 0:
+                raise ValueError("Timestamp clock frequency unknown, so can't convert to seconds; use ticks() instead")
+            return self.ticks() / frequency
+
+    %}
+
+};
+
+// Both build Python objects, so need to keep hold of the GIL
+%nothread Burst::array;
+%nothread Burst::ticks;
+
+%extend Burst {
+
+    /// @brief Wraps the pixels in a NumPy array without copying them.
+    PyObject* array() {
+        return sharedArray($self->share(), {(npy_intp) $self->getCount(), (npy_intp) $self->getHeight(), (npy_intp) $self->getWidth()}, NPY_UINT16);
+    }
+
+    /// @brief Wraps the timestamps, in clock ticks, in a NumPy array without copying them.
+    PyObject* ticks() {
+        return sharedArray($self->shareTimestamps(), {(npy_intp) $self->getCount()}, NPY_INT64);
+    }
+
+};
+
 class Zyla {
 
     public:
@@ -177,6 +510,8 @@ class Zyla {
 
     Acquisition acquire(int timeout);
 
+    Burst acquireBurst(long count, int timeout, int threads = 1);
+
     long getAccumulateCount();
 
     void setAccumulateCount(long value);
@@ -1,37 +1,101 @@
+#pragma once
 #include "atcore.h"
 #include "atutility.h"
 #include <string>
 #include <iostream>
 #include <sstream>
+#include <map>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
 
 using namespace std;
 
-
-string wcTostring(AT_WC* wc) {
+std::map<int, std::string> errorNames {
+
+    {AT_SUCCESS, "SUCCESS"},
+    {AT_ERR_NOTINITIALISED, "ERR_NOTINITIALISED"},
+    {AT_ERR_NOTIMPLEMENTED, "ERR_NOTIMPLEMENTED"},
+    {AT_ERR_READONLY, "ERR_READONLY"},
+    {AT_ERR_NOTREADABLE, "ERR_NOTREADABLE"},
+    {AT_ERR_NOTWRITABLE, "ERR_NOTWRITABLE"},
+    {AT_ERR_OUTOFRANGE, "ERR_OUTOFRANGE"},
+    {AT_ERR_INDEXNOTAVAILABLE, "ERR_INDEXNOTAVAILABLE"},
+    {AT_ERR_INDEXNOTIMPLEMENTED, "ERR_INDEXNOTIMPLEMENTED"},
+    {AT_ERR_EXCEEDEDMAXSTRINGLENGTH, "ERR_EXCEEDEDMAXSTRINGLENGTH"},
+    {AT_ERR_CONNECTION, "ERR_CONNECTION"},
+    {AT_ERR_NODATA, "ERR_NODATA"},
+    {AT_ERR_INVALIDHANDLE, "ERR_INVALIDHANDLE"},
+    {AT_ERR_TIMEDOUT, "ERR_TIMEDOUT"},
+    {AT_ERR_BUFFERFULL, "ERR_BUFFERFULL"},
+    {AT_ERR_INVALIDSIZE, "ERR_INVALIDSIZE"},
+    {AT_ERR_INVALIDALIGNMENT, "ERR_INVALIDALIGNMENT"},
+    {AT_ERR_COMM, "ERR_COMM"},
+    {AT_ERR_STRINGNOTAVAILABLE, "ERR_STRINGNOTAVAILABLE"},
+    {AT_ERR_STRINGNOTIMPLEMENTED, "ERR_STRINGNOTIMPLEMENTED"},
+    {AT_ERR_NULL_FEATURE, "ERR_NULL_FEATURE"},
+    {AT_ERR_NULL_HANDLE, "ERR_NULL_HANDLE"},
+    {AT_ERR_NULL_IMPLEMENTED_VAR, "ERR_NULL_IMPLEMENTED_VAR"},
+    {AT_ERR_NULL_READABLE_VAR, "ERR_NULL_READABLE_VAR"},
+    {AT_ERR_NULL_READONLY_VAR, "ERR_NULL_READONLY_VAR"},
+    {AT_ERR_NULL_WRITABLE_VAR, "ERR_NULL_WRITABLE_VAR"},
+    {AT_ERR_NULL_MINVALUE, "ERR_NULL_MINVALUE"},
+    {AT_ERR_NULL_MAXVALUE, "ERR_NULL_MAXVALUE"},
+    {AT_ERR_NULL_VALUE, "ERR_NULL_VALUE"},
+    {AT_ERR_NULL_STRING, "ERR_NULL_STRING"},
+    {AT_ERR_NULL_COUNT_VAR, "ERR_NULL_COUNT_VAR"},
+    {AT_ERR_NULL_ISAVAILABLE_VAR, "ERR_NULL_ISAVAILABLE_VAR"},
+    {AT_ERR_NULL_MAXSTRINGLENGTH, "ERR_NULL_MAXSTRINGLENGTH"},
+    {AT_ERR_NULL_EVCALLBACK, "ERR_NULL_EVCALLBACK"},
+    {AT_ERR_NULL_QUEUE_PTR, "ERR_NULL_QUEUE_PTR"},
+    {AT_ERR_NULL_WAIT_PTR, "ERR_NULL_WAIT_PTR"},
+    {AT_ERR_NULL_PTRSIZE, "ERR_NULL_PTRSIZE"},
+    {AT_ERR_NOMEMORY, "ERR_NOMEMORY"},
+    {AT_ERR_DEVICEINUSE, "ERR_DEVICEINUSE"},
+    {AT_ERR_DEVICENOTFOUND, "ERR_DEVICENOTFOUND"},
+    {AT_ERR_HARDWARE_OVERFLOW, "ERR_HARDWARE_OVERFLOW"}
+
+};
+
+
+string wcTostring(const AT_WC* wc) {
 
     wstring wString = wstring(wc);
     return string(wString.begin(), wString.end());
 
 }
 
-AT_WC* stringToWC(string str) {
+/// @brief The wide-character version of a feature name (or enumerated option) that
+/// the SDK wants. Each name is converted the first time it's asked for and then kept
+/// in a table shared by all threads, so asking again allocates nothing and the
+/// pointer returned stays valid for as long as the program runs. Names known when
+/// compiling are better passed to the SDK as wide literals (e.g., L"AOIWidth").
+const AT_WC* internWC(const string& name) {
+
+    static shared_mutex                   lock;
+    static unordered_map<string, wstring> names;
 
-    size_t length = str.length();
+    {
+        shared_lock<shared_mutex> guard(lock);
 
-    wstring wString = wstring(str.begin(), str.end());
-    wString.resize(length);
-    AT_WC* wc = new AT_WC[length + 1];
-    wString.copy(wc, length, 0); 
-    wc[length] = L'\0';
+        auto found = names.find(name);
+
+        if (found != names.end()) {
+            return found->second.c_str();
+        }
+    }
 
-    return wc;
+    unique_lock<shared_mutex> guard(lock);
+
+    // Entries never move once added, so neither do their strings
+    return names.emplace(name, wstring(name.begin(), name.end())).first->second.c_str();
 
 }
 
 long getInt(AT_H handle, string feature) {
 
     AT_64 value;
-    int result = AT_GetInt(handle, stringToWC(feature), &value);
+    int result = AT_GetInt(handle, internWC(feature), &value);
 
     if (result != AT_SUCCESS) {
         ostringstream oss;
@@ -45,7 +109,7 @@ long getInt(AT_H handle, string feature) {
 void setInt(AT_H handle, string feature, long value) {
 
 
-    int result = AT_SetInt(handle, stringToWC(feature), value);
+    int result = AT_SetInt(handle, internWC(feature), value);
 
     if (result != AT_SUCCESS) {
         ostringstream oss;
@@ -58,7 +122,7 @@ void setInt(AT_H handle, string feature, long value) {
 long getIntMin(AT_H handle, string feature) {
 
     AT_64 value;
-    int result = AT_GetIntMin(handle, stringToWC(feature), &value);
+    int result = AT_GetIntMin(handle, internWC(feature), &value);
 
     if (result != AT_SUCCESS) {
         ostringstream oss;
@@ -72,7 +136,7 @@ long getIntMin(AT_H handle, string feature) {
 bool getBool(AT_H handle, string feature) {
 
     AT_BOOL value;
-    int result = AT_GetBool(handle, stringToWC(feature), &value);
+    int result = AT_GetBool(handle, internWC(feature), &value);
 
     if (result != AT_SUCCESS) {
         ostringstream oss;
@@ -86,7 +150,7 @@ bool getBool(AT_H handle, string feature) {
 void setBool(AT_H handle, string feature, bool value) {
 
 
-    int result = AT_SetBool(handle, stringToWC(feature), value);
+    int result = AT_SetBool(handle, internWC(feature), value);
 
     if (result != AT_SUCCESS) {
         ostringstream oss;
@@ -99,7 +163,7 @@ void setBool(AT_H handle, string feature, bool value) {
 double getFloat(AT_H handle, string feature) {
 
     double value;
-    int result = AT_GetFloat(handle, stringToWC(feature), &value);
+    int result = AT_GetFloat(handle, internWC(feature), &value);
 
     if (result != AT_SUCCESS) {
         ostringstream oss;
@@ -113,7 +177,7 @@ double getFloat(AT_H handle, string feature) {
 double getFloatMin(AT_H handle, string feature) {
 
     double value;
-    int result = AT_GetFloatMin(handle, stringToWC(feature), &value);
+    int result = AT_GetFloatMin(handle, internWC(feature), &value);
 
     if (result != AT_SUCCESS) {
         ostringstream oss;
@@ -127,7 +191,7 @@ double getFloatMin(AT_H handle, string feature) {
 void setFloat(AT_H handle, string feature, double value) {
 
 
-    int result = AT_SetFloat(handle, stringToWC(feature), value);
+    int result = AT_SetFloat(handle, internWC(feature), value);
 
     if (result != AT_SUCCESS) {
         ostringstream oss;
@@ -140,7 +204,7 @@ void setFloat(AT_H handle, string feature, double value) {
 int getEnumInt(AT_H handle, string feature) {
 
     int value;
-    int result = AT_GetEnumIndex(handle, stringToWC(feature), &value);
+    int result = AT_GetEnumIndex(handle, internWC(feature), &value);
 
     if (result != AT_SUCCESS) {
         ostringstream oss;
@@ -154,7 +218,7 @@ int getEnumInt(AT_H handle, string feature) {
 void setEnumInt(AT_H handle, string feature, int index) {
 
 
-    int result = AT_SetEnumIndex(handle, stringToWC(feature), index);
+    int result = AT_SetEnumIndex(handle, internWC(feature), index);
 
     if (result != AT_SUCCESS) {
         ostringstream oss;
@@ -166,9 +230,15 @@ void setEnumInt(AT_H handle, string feature, int index) {
 
 string getEnum(AT_H handle, string feature) {
 
-    int    value  = getEnumInt(handle, feature);
-    AT_WC* chars  = new AT_WC[1024];
-    int    result = AT_GetEnumStringByIndex(handle, stringToWC(feature), value, chars, 1024);
+    int   value = getEnumInt(handle, feature);
+    AT_WC chars[1024];
+    int   result = AT_GetEnumStringByIndex(handle, internWC(feature), value, chars, 1024);
+
+    if (result != AT_SUCCESS) {
+        ostringstream oss;
+        oss << feature << ": " << result;
+        throw oss.str();
+    }
 
     return wcTostring(chars);
 
@@ -176,8 +246,8 @@ string getEnum(AT_H handle, string feature) {
 
 string getString(AT_H handle, string feature) {
 
-    AT_WC* chars  = new AT_WC[1024];
-    int    result = AT_GetString(handle, stringToWC(feature), chars, 1024);
+    AT_WC chars[1024];
+    int   result = AT_GetString(handle, internWC(feature), chars, 1024);
 
     if (result != AT_SUCCESS) {
         ostringstream oss;
@@ -191,7 +261,7 @@ string getString(AT_H handle, string feature) {
 
 void setEnum(AT_H handle, string feature, string value) {
 
-    int result = AT_SetEnumString(handle, stringToWC(feature), stringToWC(value));
+    int result = AT_SetEnumString(handle, internWC(feature), internWC(value));
 
     if (result != AT_SUCCESS) {
         ostringstream oss;
@@ -203,7 +273,7 @@ void setEnum(AT_H handle, string feature, string value) {
 
 void printEnum(AT_H handle, string feature) {
 
-    AT_WC* f = stringToWC(feature);
+    const AT_WC* f = internWC(feature);
 
     int count;
     AT_GetEnumCount(handle, f, &count);
@@ -222,6 +292,49 @@ void printEnum(AT_H handle, string feature) {
 
 }
 
+/// @brief Notes the camera's CycleMode and FrameCount, and puts them back as they
+/// were when it goes out of scope, however that happens. For capturing a fixed run
+/// of frames without leaving the camera set up for it afterwards.
+class CycleGuard {
+
+    private:
+
+        AT_H  handle;
+        int   mode  = -1;
+        AT_64 count = -1;
+
+    public:
+
+        CycleGuard(AT_H handle) : handle(handle) {
+
+            if (AT_GetEnumIndex(handle, L"CycleMode", &mode) != AT_SUCCESS) {
+                mode = -1;
+            }
+
+            if (AT_GetInt(handle, L"FrameCount", &count) != AT_SUCCESS) {
+                count = -1;
+            }
+
+        }
+
+        CycleGuard(const CycleGuard&) = delete;
+        CycleGuard& operator=(const CycleGuard&) = delete;
+
+        // Errors are ignored, as this can run while an exception is on its way out
+        ~CycleGuard() {
+
+            if (count >= 0) {
+                AT_SetInt(handle, L"FrameCount", count);
+            }
+
+            if (mode >= 0) {
+                AT_SetEnumIndex(handle, L"CycleMode", mode);
+            }
+
+        }
+
+};
+
 AT_H open(int index) {
 
     AT_H handle;
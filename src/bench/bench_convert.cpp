@@ -0,0 +1,219 @@
+#include "convert.cpp"
+#include "atfunc.cpp"
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <vector>
+
+using namespace std;
+
+/// Measures the throughput of the native Mono16 conversion engine for each pixel
+/// encoding (and of summing rows, and of dark/flat correction) on every set of
+/// kernels the CPU supports, checking that each one produces exactly the same
+/// output as the scalar reference and, for conversion, as the SDK's own
+/// AT_ConvertBuffer() (unless built without libatutility). Any mismatch is
+/// reported as a failure, and makes the exit status non-zero.
+int main(int argc, char** argv) {
+
+    long width      = argc > 1 ? atol(argv[1]) : 2560;
+    long height     = argc > 2 ? atol(argv[2]) : 2160;
+    int  iterations = argc > 3 ? atoi(argv[3]) : 50;
+
+    vector<PixelEncoding> encodings = {MONO12, MONO12_PACKED, MONO16, MONO32};
+    vector<string>        kernels   = {"scalar", "sse4", "avx2", "neon"};
+
+    mt19937 random(1234);
+    int     failures = 0;
+
+#if defined(NO_LIB_UTILITY)
+    string sdk = "none";
+#elif defined(A3C_SIMULATOR)
+    string sdk = "simulated";
+#else
+    string sdk = "libatutility";
+#endif
+
+    AT_InitialiseUtilityLibrary();
+
+    cout << "Frame: " << width << " x " << height << ", " << iterations << " iterations, SDK reference: " << sdk << endl;
+    cout << left << setw(14) << "Encoding" << setw(8) << "Kernel" << right << setw(12) << "In GB/s" << setw(12) << "Out GB/s" << setw(10) << "Exact" << setw(10) << "SDK" << endl;
+
+    for (PixelEncoding encoding : encodings) {
+
+        // Pad each row out to a multiple of 64 bytes, as the camera would
+        long stride = (encodingRowBytes(encoding, width) + 63) & ~63L;
+
+        vector<uint8_t>  input(stride * height);
+        vector<uint16_t> reference(width * height);
+        vector<uint16_t> output(width * height);
+
+        for (auto& byte : input) {
+            byte = (uint8_t) random();
+        }
+
+        setConversionKernel("scalar");
+        convertToMono16(input.data(), reference.data(), width, height, stride, encoding, input.size());
+
+        // What the SDK makes of the same buffer, which every kernel has to match bit for bit
+        vector<uint16_t> converted(width * height);
+        bool             haveSDK = false;
+
+#if !defined(NO_LIB_UTILITY)
+        int result = AT_ConvertBuffer(input.data(), (unsigned char*) converted.data(), width, height, stride, internWC(encodingName(encoding)), L"Mono16");
+
+        if (result == AT_SUCCESS) {
+            haveSDK = true;
+        } else {
+            cout << "FAIL: AT_ConvertBuffer() couldn't convert " << encodingName(encoding) << " (" << errorNames[result] << ")" << endl;
+            failures++;
+        }
+#endif
+
+        for (string kernel : kernels) {
+
+            if (!setConversionKernel(kernel)) {
+                continue;
+            }
+
+            convertToMono16(input.data(), output.data(), width, height, stride, encoding, input.size());
+
+            bool exact   = output == reference;
+            bool matched = haveSDK && output == converted;
+            auto start   = chrono::steady_clock::now();
+
+            for (int i = 0; i < iterations; i++) {
+                convertToMono16(input.data(), output.data(), width, height, stride, encoding, input.size());
+            }
+
+            double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+            double inRate  = (double) input.size() * iterations / seconds / 1e9;
+            double outRate = (double) output.size() * 2 * iterations / seconds / 1e9;
+
+            cout << left << setw(14) << encodingName(encoding) << setw(8) << kernel << right << fixed << setprecision(2)
+                 << setw(12) << inRate << setw(12) << outRate << setw(10) << (exact ? "yes" : "NO")
+                 << setw(10) << (!haveSDK ? "-" : matched ? "yes" : "NO") << endl;
+
+            if (!exact) {
+                cout << "FAIL: " << kernel << " " << encodingName(encoding) << " conversion differs from scalar" << endl;
+                failures++;
+            }
+
+            if (haveSDK && !matched) {
+                cout << "FAIL: " << kernel << " " << encodingName(encoding) << " conversion differs from AT_ConvertBuffer()" << endl;
+                failures++;
+            }
+
+        }
+
+    }
+
+    // Summing rows into 32-bit totals, as done to turn tracks into spectra and to co-add frames
+    vector<uint16_t> rows(width * height);
+    vector<uint32_t> reference(width);
+    vector<uint32_t> sums(width);
+
+    for (auto& pixel : rows) {
+        pixel = (uint16_t) random();
+    }
+
+    setConversionKernel("scalar");
+    sumRows(rows.data(), reference.data(), width, height);
+
+    for (string kernel : kernels) {
+
+        if (!setConversionKernel(kernel)) {
+            continue;
+        }
+
+        sumRows(rows.data(), sums.data(), width, height);
+
+        bool exact = sums == reference;
+
+        // Taking every row back off again, as a sliding co-add window does, should leave nothing
+        vector<uint32_t> remaining = sums;
+
+        for (long y = 0; y < height; y++) {
+            activeKernels().subtract16(rows.data() + y * width, remaining.data(), width);
+        }
+
+        exact = exact && remaining == vector<uint32_t>(width, 0);
+        auto start = chrono::steady_clock::now();
+
+        for (int i = 0; i < iterations; i++) {
+            sumRows(rows.data(), sums.data(), width, height);
+        }
+
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        double inRate  = (double) rows.size() * 2 * iterations / seconds / 1e9;
+        double outRate = (double) sums.size() * 4 * iterations / seconds / 1e9;
+
+        cout << left << setw(14) << "Row sums" << setw(8) << kernel << right << fixed << setprecision(2)
+             << setw(12) << inRate << setw(12) << outRate << setw(10) << (exact ? "yes" : "NO") << endl;
+
+        if (!exact) {
+            cout << "FAIL: " << kernel << " row sums differ from scalar" << endl;
+            failures++;
+        }
+
+    }
+
+    // Dark and flat correction, to Mono16 and to Float32
+    vector<float>    offsets(width * height);
+    vector<float>    gains(width * height);
+    vector<uint16_t> corrected16(width * height), expected16(width * height);
+    vector<float>    correctedFloat(width * height), expectedFloat(width * height);
+
+    uniform_real_distribution<float> offset(0.0f, 2000.0f);
+    uniform_real_distribution<float> gain(0.5f, 1.5f);
+
+    for (long i = 0; i < width * height; i++) {
+        offsets[i] = offset(random);
+        gains[i]   = gain(random);
+    }
+
+    setConversionKernel("scalar");
+    activeKernels().correct16(rows.data(), offsets.data(), gains.data(), expected16.data(), rows.size());
+    activeKernels().correctFloat(rows.data(), offsets.data(), gains.data(), expectedFloat.data(), rows.size());
+
+    for (string kernel : kernels) {
+
+        if (!setConversionKernel(kernel)) {
+            continue;
+        }
+
+        activeKernels().correct16(rows.data(), offsets.data(), gains.data(), corrected16.data(), rows.size());
+        activeKernels().correctFloat(rows.data(), offsets.data(), gains.data(), correctedFloat.data(), rows.size());
+
+        bool exact = corrected16 == expected16 && correctedFloat == expectedFloat;
+        auto start = chrono::steady_clock::now();
+
+        for (int i = 0; i < iterations; i++) {
+            activeKernels().correct16(rows.data(), offsets.data(), gains.data(), corrected16.data(), rows.size());
+        }
+
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        double inRate  = (double) rows.size() * 2 * iterations / seconds / 1e9;
+
+        cout << left << setw(14) << "Correct" << setw(8) << kernel << right << fixed << setprecision(2)
+             << setw(12) << inRate << setw(12) << inRate << setw(10) << (exact ? "yes" : "NO") << endl;
+
+        if (!exact) {
+            cout << "FAIL: " << kernel << " correction differs from scalar" << endl;
+            failures++;
+        }
+
+    }
+
+#if !defined(NO_LIB_UTILITY)
+    AT_FinaliseUtilityLibrary();
+#endif
+
+    if (failures > 0) {
+        cout << failures << " check(s) FAILED" << endl;
+        return 1;
+    }
+
+    return 0;
+
+}
@@ -0,0 +1,431 @@
+#include "A3C.cpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+#if defined(_WIN32)
+#include <windows.h>
+#include <psapi.h>
+#pragma comment(lib, "psapi")
+#else
+#include <sys/resource.h>
+#endif
+
+using namespace std;
+
+/// Benchmarks each stage of the A3C pipeline in isolation (queues, conversion and
+/// writing) on synthetic frames of realistic Zyla geometries, then the whole
+/// pipeline end-to-end against the simulated SDK, and prints the results as JSON
+/// on stdout (progress goes to stderr) so that runs can be compared between
+/// releases.
+///
+/// Usage: bench_pipeline [seconds per case] [output directory]
+
+/// @brief Frame geometry to benchmark, as it would be set on the camera.
+struct Geometry {
+
+    string name;
+    long   width;
+    long   height;
+    int    tracks;
+    string binning;
+
+};
+
+/// @brief Collects per-item latencies (in microseconds) and summarises them.
+struct Latency {
+
+    vector<double> samples;
+
+    void add(chrono::steady_clock::duration elapsed) {
+        samples.push_back(chrono::duration<double, micro>(elapsed).count());
+    }
+
+    double percentile(double p) {
+
+        if (samples.empty()) {
+            return 0;
+        }
+
+        size_t index = (size_t) (p / 100.0 * (samples.size() - 1));
+
+        nth_element(samples.begin(), samples.begin() + index, samples.end());
+
+        return samples[index];
+
+    }
+
+    string json() {
+
+        stringstream stream;
+
+        stream << fixed << setprecision(2)
+               << "{\"p50\": " << percentile(50) << ", \"p90\": " << percentile(90)
+               << ", \"p99\": " << percentile(99) << ", \"max\": " << percentile(100) << "}";
+
+        return stream.str();
+
+    }
+
+};
+
+/// @brief Peak resident set size of the process so far, in bytes. This only ever
+/// goes up, so it is the high-water mark of everything that ran before.
+long peakRSS() {
+
+#if defined(_WIN32)
+    PROCESS_MEMORY_COUNTERS counters;
+    GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters));
+    return (long) counters.PeakWorkingSetSize;
+#else
+    rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss * 1024L;
+#endif
+
+}
+
+vector<string> results;
+
+void record(string section, string fields) {
+    results.push_back("    {\"section\": \"" + section + "\", " + fields + ", \"peakRSS\": " + to_string(peakRSS()) + "}");
+}
+
+string rates(long frames, long bytes, double seconds) {
+
+    stringstream stream;
+
+    stream << fixed << setprecision(2)
+           << "\"frames\": " << frames << ", \"fps\": " << frames / seconds << ", \"MBps\": " << bytes / seconds / 1e6;
+
+    return stream.str();
+
+}
+
+/// @brief Passes frames from one thread to another through a queue for the given
+/// time, timing each one from push to pop.
+template<typename Queue> void benchQueue(string name, Queue& queue, double seconds) {
+
+    cerr << "queue: " << name << endl;
+
+    Latency latency;
+    long    count = 0;
+
+    thread consumer([&]() {
+
+        while (true) {
+
+            Frame frame = queue.pop();
+
+            if (frame.isEnd()) {
+                break;
+            }
+
+            latency.add(chrono::steady_clock::now() - chrono::steady_clock::time_point(chrono::steady_clock::duration(frame.metadata.timestamp)));
+            count++;
+
+        }
+
+    });
+
+    auto start = chrono::steady_clock::now();
+    auto until = start + chrono::duration_cast<chrono::steady_clock::duration>(chrono::duration<double>(seconds));
+    long sent  = 0;
+
+    while (chrono::steady_clock::now() < until) {
+
+        Frame frame;
+        frame.sequence           = sent++;
+        frame.metadata.timestamp = chrono::steady_clock::now().time_since_epoch().count();
+
+        queue.push(frame);
+
+    }
+
+    queue.push(Frame());
+    consumer.join();
+
+    double elapsed = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    record("queue", "\"queue\": \"" + name + "\", " + rates(count, count * sizeof(Frame), elapsed) + ", \"latencyUs\": " + latency.json());
+
+}
+
+/// @brief Lays out a synthetic raw frame for a geometry and encoding as the camera
+/// would, with rows padded out to a multiple of 8 bytes.
+vector<uint8_t> rawFrame(Geometry geometry, PixelEncoding encoding, long& stride) {
+
+    stride = (encodingRowBytes(encoding, geometry.width) + 7) & ~7L;
+
+    vector<uint8_t> raw(stride * geometry.height);
+
+    for (size_t i = 0; i < raw.size(); i++) {
+        raw[i] = (uint8_t) (i * 2654435761u >> 13);
+    }
+
+    return raw;
+
+}
+
+void benchConvert(Geometry geometry, PixelEncoding encoding, bool native, double seconds) {
+
+    string path = native ? "native:" + getConversionKernel() : "sdk";
+
+    cerr << "convert: " << geometry.name << ", " << encodingName(encoding) << ", " << path << endl;
+
+    long             stride;
+    vector<uint8_t>  raw = rawFrame(geometry, encoding, stride);
+    vector<uint16_t> output(geometry.width * geometry.height);
+    string           text = encodingName(encoding);
+    wstring          name = wstring(text.begin(), text.end());
+
+    Latency latency;
+    long    count = 0;
+    auto    start = chrono::steady_clock::now();
+    auto    until = start + chrono::duration_cast<chrono::steady_clock::duration>(chrono::duration<double>(seconds));
+
+    while (chrono::steady_clock::now() < until) {
+
+        auto began = chrono::steady_clock::now();
+
+        if (native) {
+            convertToMono16(raw.data(), output.data(), geometry.width, geometry.height, stride, encoding, raw.size());
+        } else {
+            AT_ConvertBuffer(raw.data(), (AT_U8*) output.data(), geometry.width, geometry.height, stride, name.c_str(), L"Mono16");
+        }
+
+        latency.add(chrono::steady_clock::now() - began);
+        count++;
+
+    }
+
+    double elapsed = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    record("convert", "\"geometry\": \"" + geometry.name + "\", \"encoding\": \"" + encodingName(encoding) + "\", \"path\": \"" + path + "\", "
+        + rates(count, count * (long) raw.size(), elapsed) + ", \"latencyUs\": " + latency.json());
+
+}
+
+/// @brief Writes Mono16 frames to a file through one of A3C's writer backends,
+/// timing each call to write() (for asynchronous backends that is the time to
+/// queue the frame, so the final flush is included in the overall rate).
+void benchWrite(Geometry geometry, string backend, string directory, double seconds) {
+
+    string path = directory + "/bench_pipeline.bin";
+
+    cerr << "write: " << geometry.name << ", " << backend << endl;
+
+    long frameBytes = geometry.width * geometry.height * 2;
+
+    unique_ptr<Writer> output(createWriter(backend, [](unsigned char* buffer) {
+        delete[] (unsigned short*) buffer;
+    }));
+
+    A3CHeader header = A3CHeader(geometry.width, geometry.height, "Mono16");
+
+    output->open(path, sizeof(A3CHeader));
+    output->writeAt(&header, sizeof(A3CHeader), 0);
+
+    Latency latency;
+    long    count = 0;
+    auto    start = chrono::steady_clock::now();
+    auto    until = start + chrono::duration_cast<chrono::steady_clock::duration>(chrono::duration<double>(seconds));
+
+    while (chrono::steady_clock::now() < until) {
+
+        // A fresh buffer each time, as the writer owns (and frees) whatever it is given
+        unsigned short* frame = new unsigned short[geometry.width * geometry.height];
+        memset(frame, 0x0A, frameBytes);
+
+        auto began = chrono::steady_clock::now();
+
+        output->write((unsigned char*) frame, frameBytes);
+
+        latency.add(chrono::steady_clock::now() - began);
+        count++;
+
+    }
+
+    output->flush();
+    output->close();
+
+    double elapsed = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    remove(path.c_str());
+
+    record("write", "\"geometry\": \"" + geometry.name + "\", \"backend\": \"" + output->getName() + "\", "
+        + rates(count, count * frameBytes, elapsed) + ", \"latencyUs\": " + latency.json());
+
+}
+
+/// @brief Sets the camera up for a geometry, with metadata turned on as A3C would.
+void configure(AT_H handle, Geometry geometry, PixelEncoding encoding) {
+
+    setEnum(handle, "PixelEncoding", encodingName(encoding));
+    setEnum(handle, "AOIBinning", geometry.binning);
+
+    if (geometry.tracks > 0) {
+
+        long rows = geometry.height / geometry.tracks;
+
+        setEnum(handle, "AOILayout", "Multitrack");
+        setInt(handle, "MultitrackCount", geometry.tracks);
+
+        for (int i = 0; i < geometry.tracks; i++) {
+            setInt(handle, "MultitrackSelector", i);
+            setInt(handle, "MultitrackStart", 1 + i * rows * 4);
+            setInt(handle, "MultitrackEnd", i * rows * 4 + rows);
+            setBool(handle, "MultitrackBinned", false);
+        }
+
+    } else {
+        setEnum(handle, "AOILayout", "Image");
+        setInt(handle, "AOIHeight", geometry.height);
+    }
+
+    setInt(handle, "AOIWidth", geometry.width);
+
+}
+
+/// @brief Runs the full A3C pipeline against the free-running simulated camera,
+/// so that it is limited only by how fast the pipeline can take frames.
+void benchPipeline(AT_H handle, Geometry geometry, PixelEncoding encoding, bool native, string backend, string directory, double seconds) {
+
+    string path = native ? "native:" + getConversionKernel() : "sdk";
+
+    cerr << "pipeline: " << geometry.name << ", " << encodingName(encoding) << ", " << path << ", " << backend << endl;
+
+    configure(handle, geometry, encoding);
+
+    A3C capture = A3C(handle);
+
+    capture.setVerbose(false);
+    capture.setNativeConversion(native);
+    capture.setWriterBackend(backend);
+    capture.setOutputPath(directory + "/bench_pipeline.bin");
+    capture.setLatencyTracking(true);
+
+    auto start = chrono::steady_clock::now();
+
+    capture.start();
+    this_thread::sleep_for(chrono::duration<double>(seconds));
+    capture.stop();
+
+    double elapsed = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    long   frames  = capture.getAcquireCount();
+
+    remove((directory + "/bench_pipeline.bin").c_str());
+    remove((directory + "/bench_pipeline.bin" + A3C_INDEX_EXTENSION).c_str());
+
+    stringstream fields;
+
+    fields << "\"geometry\": \"" << geometry.name << "\", \"encoding\": \"" << encodingName(encoding) << "\", \"path\": \"" << path
+           << "\", \"queue\": \"RingBuffer\", \"backend\": \"" << backend << "\", " << rates(frames, capture.getWrittenBytes(), elapsed)
+           << ", \"poolStalls\": " << capture.getPoolStalls() << ", \"cameraDropped\": " << getInt(handle, "SimDroppedFrames")
+           << ", \"processQueueMax\": " << capture.getProcessQueueHighWatermark() << ", \"writeQueueMax\": " << capture.getWriteQueueHighWatermark()
+           << ", \"latencyUs\": {";
+
+    // Time each frame spent in each stage, from the camera handing it over to it being written
+    vector<string> stages = {"process", "reorder", "write", "total"};
+
+    for (size_t i = 0; i < stages.size(); i++) {
+        Latency latency = {capture.getLatencies(stages[i])};
+        fields << (i > 0 ? ", " : "") << "\"" << stages[i] << "\": " << latency.json();
+    }
+
+    fields << "}";
+
+    record("pipeline", fields.str());
+
+}
+
+int main(int argc, char** argv) {
+
+    double seconds   = argc > 1 ? atof(argv[1]) : 1.0;
+    string directory = argc > 2 ? argv[2] : ".";
+
+    vector<Geometry> geometries = {
+        {"full",       2560, 2160, 0, "1x1"},
+        {"multitrack", 2560, 64,   4, "1x1"},
+        {"binned",     1280, 1080, 0, "2x2"}
+    };
+
+    vector<PixelEncoding> encodings = {MONO12, MONO12_PACKED, MONO16, MONO32};
+
+    AT_InitialiseLibrary();
+    AT_InitialiseUtilityLibrary();
+
+    RingBuffer<Frame> ring;
+    FIFOQueue<Frame>  fifo;
+
+    ring.resize(256);
+
+    benchQueue("RingBuffer", ring, seconds);
+    benchQueue("FIFOQueue", fifo, seconds);
+
+    for (Geometry geometry : geometries) {
+
+        for (PixelEncoding encoding : encodings) {
+            benchConvert(geometry, encoding, true, seconds);
+            benchConvert(geometry, encoding, false, seconds);
+        }
+
+        for (string backend : writerBackends()) {
+            benchWrite(geometry, backend, directory, seconds);
+        }
+
+    }
+
+    // The end-to-end runs need a camera that can be told to free-run, i.e., the simulator
+    AT_H    handle;
+    AT_BOOL simulated = false;
+
+    if (AT_Open(0, &handle) == AT_SUCCESS) {
+
+        AT_IsImplemented(handle, L"SimFreeRun", &simulated);
+
+        if (simulated) {
+
+            setBool(handle, "SimFreeRun", true);
+            setBool(handle, "SimFill", false);
+
+            for (Geometry geometry : geometries) {
+
+                benchPipeline(handle, geometry, MONO12_PACKED, false, "stream", directory, seconds);
+
+                for (string backend : writerBackends()) {
+                    benchPipeline(handle, geometry, MONO12_PACKED, true, backend, directory, seconds);
+                }
+
+            }
+
+        } else {
+            cerr << "pipeline: skipped, not running against the simulated SDK" << endl;
+        }
+
+        AT_Close(handle);
+
+    }
+
+    AT_FinaliseUtilityLibrary();
+    AT_FinaliseLibrary();
+
+    cout << "{" << endl;
+    cout << "  \"secondsPerCase\": " << seconds << "," << endl;
+    cout << "  \"results\": [" << endl;
+
+    for (size_t i = 0; i < results.size(); i++) {
+        cout << results[i] << (i + 1 < results.size() ? "," : "") << endl;
+    }
+
+    cout << "  ]," << endl;
+    cout << "  \"peakRSS\": " << peakRSS() << endl;
+    cout << "}" << endl;
+
+    return 0;
+
+}
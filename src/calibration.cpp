@@ -0,0 +1,257 @@
+#pragma once
+#include "format.cpp"
+#include "compress.cpp"
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+/// @brief Averages every frame in an A3C file (Mono16, compressed or not, or
+/// Float32), such as a run of darks captured as normal or a master saved by
+/// saveFrame(). Throws if the file can't be read.
+vector<float> loadAverage(string path, long& width, long& height) {
+
+    ifstream       file(path, ios::binary);
+    ifstream       index(path + A3C_INDEX_EXTENSION, ios::binary);
+    A3CHeader      header;
+    A3CIndexHeader indexHeader;
+
+    if (!file.read((char*) &header, sizeof(header)) || memcmp(header.magic, A3C_FILE_MAGIC, 4) != 0) {
+        throw path + " is not an A3C file";
+    }
+
+    if (!index.read((char*) &indexHeader, sizeof(indexHeader)) || memcmp(indexHeader.magic, A3C_INDEX_MAGIC, 4) != 0) {
+        throw "Missing or invalid index for " + path;
+    }
+
+    string encoding = string(header.encoding, strnlen(header.encoding, sizeof(header.encoding)));
+
+    if (encoding != "Mono16" && encoding != "Float32") {
+        throw "Can't average " + encoding + " frames from " + path;
+    }
+
+    vector<A3CIndexRecord> records;
+    A3CIndexRecord         record;
+
+    index.seekg(indexHeader.headerSize);
+
+    while (index.read((char*) &record, sizeof(record))) {
+        records.push_back(record);
+    }
+
+    // A frame count of zero means the capture didn't finish cleanly, but the index still has what made it
+    if (header.frameCount > 0 && header.frameCount < records.size()) {
+        records.resize(header.frameCount);
+    }
+
+    if (records.empty()) {
+        throw path + " has no frames in it";
+    }
+
+    width  = header.width;
+    height = header.height;
+
+    long pixels = width * height;
+    long bytes  = header.frameBytes();
+
+    vector<double>   sum(pixels, 0.0);
+    vector<uint8_t>  data;
+    vector<uint16_t> words(bytes / 2);
+
+    for (A3CIndexRecord& entry : records) {
+
+        data.resize(entry.bytes);
+        file.seekg(entry.offset);
+
+        if (!file.read((char*) data.data(), entry.bytes)) {
+            throw "Could not read frame " + to_string(entry.sequence) + " from " + path;
+        }
+
+        // Anything compressed was compressed as 16-bit words, whatever its pixels really are
+        if (header.compression == A3C_COMPRESSION_DELTAPACK) {
+
+            if (!deltapackDecompress(data.data(), entry.bytes, words.data(), words.size())) {
+                throw "Corrupt frame " + to_string(entry.sequence) + " in " + path;
+            }
+
+        } else if (entry.bytes == bytes) {
+            memcpy(words.data(), data.data(), bytes);
+        } else {
+            throw "Frame " + to_string(entry.sequence) + " in " + path + " is the wrong size";
+        }
+
+        if (encoding == "Float32") {
+
+            const float* values = (const float*) words.data();
+
+            for (long i = 0; i < pixels; i++) {
+                sum[i] += values[i];
+            }
+
+        } else {
+
+            for (long i = 0; i < pixels; i++) {
+                sum[i] += words[i];
+            }
+
+        }
+
+    }
+
+    vector<float> average(pixels);
+
+    for (long i = 0; i < pixels; i++) {
+        average[i] = (float) (sum[i] / records.size());
+    }
+
+    return average;
+
+}
+
+/// @brief Saves a single Float32 frame (e.g., a master dark) as an A3C file, with
+/// its index, so that it can be loaded back with loadAverage().
+void saveFrame(string path, const vector<float>& frame, long width, long height) {
+
+    A3CHeader header(width, height, "Float32");
+    header.frameCount = 1;
+
+    A3CIndexRecord record = {0, 0, sizeof(A3CHeader), (uint32_t) header.frameBytes(), 0};
+
+    ofstream file(path, ios::binary | ios::out);
+    ofstream index(path + A3C_INDEX_EXTENSION, ios::binary | ios::out);
+
+    header.write(file);
+    file.write((const char*) frame.data(), header.frameBytes());
+
+    A3CIndexHeader().write(index);
+    index.write((const char*) &record, sizeof(record));
+
+    if (!file || !index) {
+        throw "Could not write " + path;
+    }
+
+}
+
+/// @brief Master dark and flat frames, from which the offset and gain applied to
+/// each frame as (raw - offset) * gain are worked out. The offset is the dark (or
+/// zero without one), and the gain is the mean of the flat, less the dark, divided
+/// by each of its pixels, so that a corrected flat comes out even at its original
+/// level. Pixels no brighter in the flat than in the dark get a gain of zero.
+class Calibration {
+
+    private:
+
+        long          width  = 0;
+        long          height = 0;
+        vector<float> dark;
+        vector<float> flat;
+
+        void checkSize(long frameWidth, long frameHeight) {
+
+            if (!isEmpty() && (frameWidth != width || frameHeight != height)) {
+                throw "Calibration frames must all be " + to_string(width) + " x " + to_string(height)
+                    + ", not " + to_string(frameWidth) + " x " + to_string(frameHeight);
+            }
+
+        }
+
+    public:
+
+        vector<float> offset;
+        vector<float> gain;
+
+        void setDark(vector<float> frame, long frameWidth, long frameHeight) {
+
+            if (!hasFlat()) {
+                width  = frameWidth;
+                height = frameHeight;
+            }
+
+            checkSize(frameWidth, frameHeight);
+
+            dark = frame;
+
+        }
+
+        void setFlat(vector<float> frame, long frameWidth, long frameHeight) {
+
+            if (!hasDark()) {
+                width  = frameWidth;
+                height = frameHeight;
+            }
+
+            checkSize(frameWidth, frameHeight);
+
+            flat = frame;
+
+        }
+
+        void clearDark() {
+            dark.clear();
+        }
+
+        void clearFlat() {
+            flat.clear();
+        }
+
+        bool hasDark() {
+            return !dark.empty();
+        }
+
+        bool hasFlat() {
+            return !flat.empty();
+        }
+
+        bool isEmpty() {
+            return dark.empty() && flat.empty();
+        }
+
+        const vector<float>& getDark() {
+            return dark;
+        }
+
+        const vector<float>& getFlat() {
+            return flat;
+        }
+
+        long getWidth() {
+            return width;
+        }
+
+        long getHeight() {
+            return height;
+        }
+
+        /// @brief Works out the offset and gain for frames of the given size, throwing
+        /// if the masters are a different size.
+        void prepare(long frameWidth, long frameHeight) {
+
+            checkSize(frameWidth, frameHeight);
+
+            long pixels = frameWidth * frameHeight;
+
+            offset = hasDark() ? dark : vector<float>(pixels, 0.0f);
+            gain   = vector<float>(pixels, 1.0f);
+
+            if (!hasFlat()) {
+                return;
+            }
+
+            double total = 0;
+
+            for (long i = 0; i < pixels; i++) {
+                total += flat[i] - offset[i];
+            }
+
+            float mean = (float) (total / pixels);
+
+            for (long i = 0; i < pixels; i++) {
+                float level = flat[i] - offset[i];
+                gain[i]     = level > 0 ? mean / level : 0.0f;
+            }
+
+        }
+
+};
@@ -0,0 +1,138 @@
+#pragma once
+#include "frame.cpp"
+#include "convert.cpp"
+#include <algorithm>
+#include <cstring>
+#include <deque>
+#include <vector>
+
+using namespace std;
+
+// Most frames that can go into one sum, as 32-bit totals of 16-bit pixels can't overflow before then
+#define COADD_MAX_FRAMES 65537
+
+/// @brief Sums consecutive Mono16 frames into 32-bit totals, giving out a sum of
+/// the last `frames` frames every `stride` frames. With the stride equal to the
+/// number of frames (the default) the sums don't overlap, and each frame's pixels
+/// are freed as soon as they have been added in. With a shorter stride the sums
+/// form a sliding window, which means holding on to the frames currently in it so
+/// they can be taken out of the totals again as it moves along.
+///
+/// Frames must be added in order. Each sum comes out as a Frame whose data holds
+/// width * height 32-bit totals (allocated like any other frame's data), carrying
+/// the sequence number and metadata of the first frame in it, and the status
+/// flags of all of them.
+class Coadder {
+
+    private:
+
+        long             frames = 1;
+        long             stride = 1;
+        long             pixels = 0;
+        long             count  = 0;
+        long             since  = 0;
+        int              status = 0;
+        Frame            first;
+        vector<uint32_t> sum;
+        deque<Frame>     window;
+
+        bool isSliding() {
+            return stride < frames;
+        }
+
+    public:
+
+        ~Coadder() {
+            clear();
+        }
+
+        void reset(long frames, long stride, long pixels) {
+
+            clear();
+
+            this->frames = frames;
+            this->stride = stride > 0 && stride < frames ? stride : frames;
+            this->pixels = pixels;
+
+            sum.assign(pixels, 0);
+
+        }
+
+        /// @brief Takes ownership of a frame's pixels, adding them to the totals. Returns
+        /// true, with the sum in out, if the frame completes one.
+        bool add(Frame& frame, Frame& out) {
+
+            activeKernels().accumulate16(frame.data, sum.data(), pixels);
+
+            if (isSliding()) {
+
+                window.push_back(frame);
+
+                if ((long) window.size() > frames) {
+                    activeKernels().subtract16(window.front().data, sum.data(), pixels);
+                    delete[] window.front().data;
+                    window.pop_front();
+                }
+
+                // Only give a sum out once the window is full, and then every stride frames
+                if ((long) window.size() < frames || since++ % stride != 0) {
+                    return false;
+                }
+
+                first  = window.front();
+                status = 0;
+
+                for (Frame& held : window) {
+                    status |= held.status;
+                }
+
+            } else {
+
+                if (count++ == 0) {
+                    first  = frame;
+                    status = 0;
+                }
+
+                status |= frame.status;
+
+                delete[] frame.data;
+
+                if (count < frames) {
+                    return false;
+                }
+
+                count = 0;
+
+            }
+
+            out        = first;
+            out.status = status;
+            out.data   = new unsigned short[2 * pixels];
+
+            memcpy(out.data, sum.data(), pixels * sizeof(uint32_t));
+
+            if (!isSliding()) {
+                memset(sum.data(), 0, pixels * sizeof(uint32_t));
+            }
+
+            return true;
+
+        }
+
+        /// @brief Drops any partial sum, freeing the frames held for it.
+        void clear() {
+
+            for (Frame& held : window) {
+                delete[] held.data;
+            }
+
+            window.clear();
+
+            count = 0;
+            since = 0;
+
+            fill(sum.begin(), sum.end(), 0);
+
+        }
+
+};
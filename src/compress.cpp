@@ -0,0 +1,237 @@
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+#if defined(__SSE2__) || defined(_M_X64)
+    #define A3C_SSE2
+    #include <emmintrin.h>
+#endif
+
+using namespace std;
+
+// Number of pixels sharing one bit width in a deltapack frame
+#define DELTAPACK_BLOCK 64
+
+// Lossless compression for Mono16 frames, named "deltapack". Each pixel is replaced
+// by its difference from the one before it (in row-major order, starting from zero),
+// zigzag-encoded so that small negative differences become small positive numbers.
+// These are split into blocks of DELTAPACK_BLOCK values (the last one padded with
+// zeros), and each block is bit-shuffled using just enough bits for its largest
+// value. A compressed frame is laid out as:
+//
+//   uint8  widths[blocks]           bits per value in each block (0 - 16)
+//   uint64 planes[blocks][width]    for each block in turn, one little-endian word
+//                                   per bit, with bit i of word k being bit k of
+//                                   value i in the block
+//
+// Neighbouring pixels of real images differ by little more than their noise, so
+// 12-bit data typically needs only a handful of bits per pixel.
+
+/// @brief Largest number of bytes a frame of this many pixels can compress to.
+long deltapackBound(long pixels) {
+
+    long blocks = (pixels + DELTAPACK_BLOCK - 1) / DELTAPACK_BLOCK;
+
+    return blocks + blocks * 16 * sizeof(uint64_t);
+
+}
+
+/// @brief Zigzag-encoded differences for one block, scalar version (also used for
+/// the first block, with nothing before it, and the last, which may be short).
+void deltapackResiduals(const uint16_t* in, long count, uint16_t previous, uint16_t* residuals) {
+
+    for (long i = 0; i < DELTAPACK_BLOCK; i++) {
+
+        if (i < count) {
+            int16_t delta = (int16_t) (in[i] - previous);
+            residuals[i]  = (uint16_t) ((delta << 1) ^ (delta >> 15));
+            previous      = in[i];
+        } else {
+            residuals[i] = 0;
+        }
+
+    }
+
+}
+
+int deltapackWidth(uint16_t bits) {
+
+    int width = 0;
+
+    while (bits >> width) {
+        width++;
+    }
+
+    return width;
+
+}
+
+/// @brief Writes one block of residuals as bit planes, returning the bits per value used.
+int deltapackBlockScalar(const uint16_t* residuals, uint8_t* out) {
+
+    uint16_t bits = 0;
+
+    for (int i = 0; i < DELTAPACK_BLOCK; i++) {
+        bits |= residuals[i];
+    }
+
+    int width = deltapackWidth(bits);
+
+    for (int k = 0; k < width; k++, out += sizeof(uint64_t)) {
+
+        uint64_t plane = 0;
+
+        for (int i = 0; i < DELTAPACK_BLOCK; i++) {
+            plane |= (uint64_t) ((residuals[i] >> k) & 1) << i;
+        }
+
+        memcpy(out, &plane, sizeof(plane));
+
+    }
+
+    return width;
+
+}
+
+#if defined(A3C_SSE2)
+
+/// @brief Same as deltapackBlockScalar(), but computes the residuals itself straight
+/// from the pixels (so needs a whole block with at least one pixel before it) and
+/// gathers each bit plane sixteen values at a time with movemask.
+int deltapackBlockSSE2(const uint16_t* in, uint8_t* out) {
+
+    const __m128i lowByte = _mm_set1_epi16(0x00FF);
+
+    __m128i v[8];
+    __m128i bits = _mm_setzero_si128();
+
+    for (int j = 0; j < 8; j++) {
+
+        __m128i delta = _mm_sub_epi16(_mm_loadu_si128((const __m128i*) (in + 8 * j)), _mm_loadu_si128((const __m128i*) (in + 8 * j - 1)));
+
+        v[j] = _mm_xor_si128(_mm_slli_epi16(delta, 1), _mm_srai_epi16(delta, 15));
+        bits = _mm_or_si128(bits, v[j]);
+
+    }
+
+    bits = _mm_or_si128(bits, _mm_srli_si128(bits, 8));
+    bits = _mm_or_si128(bits, _mm_srli_si128(bits, 4));
+    bits = _mm_or_si128(bits, _mm_srli_si128(bits, 2));
+
+    int width = deltapackWidth((uint16_t) _mm_cvtsi128_si32(bits));
+
+    // Low and high bytes of each group of sixteen values, in order
+    __m128i low[4], high[4];
+
+    for (int g = 0; g < 4; g++) {
+        low[g]  = _mm_packus_epi16(_mm_and_si128(v[2 * g], lowByte), _mm_and_si128(v[2 * g + 1], lowByte));
+        high[g] = _mm_packus_epi16(_mm_srli_epi16(v[2 * g], 8), _mm_srli_epi16(v[2 * g + 1], 8));
+    }
+
+    for (int k = 0; k < width; k++, out += sizeof(uint64_t)) {
+
+        __m128i* bytes = k < 8 ? low : high;
+        int      shift = 7 - (k & 7);
+        uint64_t plane = 0;
+
+        // Shifting moves bit k of each byte up to its top bit, which movemask collects
+        for (int g = 0; g < 4; g++) {
+            plane |= (uint64_t) (uint16_t) _mm_movemask_epi8(_mm_slli_epi16(bytes[g], shift)) << (16 * g);
+        }
+
+        memcpy(out, &plane, sizeof(plane));
+
+    }
+
+    return width;
+
+}
+
+#endif
+
+/// @brief Compresses a Mono16 frame, returning the number of bytes written to out
+/// (which must have room for deltapackBound(pixels) bytes).
+long deltapackCompress(const uint16_t* in, long pixels, uint8_t* out) {
+
+    long     blocks = (pixels + DELTAPACK_BLOCK - 1) / DELTAPACK_BLOCK;
+    uint8_t* widths = out;
+    uint8_t* planes = out + blocks;
+
+    uint16_t residuals[DELTAPACK_BLOCK];
+
+    for (long b = 0; b < blocks; b++) {
+
+        long start = b * DELTAPACK_BLOCK;
+        long count = pixels - start < DELTAPACK_BLOCK ? pixels - start : DELTAPACK_BLOCK;
+
+#if defined(A3C_SSE2)
+        if (start > 0 && count == DELTAPACK_BLOCK) {
+            widths[b] = (uint8_t) deltapackBlockSSE2(in + start, planes);
+            planes   += widths[b] * sizeof(uint64_t);
+            continue;
+        }
+#endif
+
+        deltapackResiduals(in + start, count, start > 0 ? in[start - 1] : 0, residuals);
+
+        widths[b] = (uint8_t) deltapackBlockScalar(residuals, planes);
+        planes   += widths[b] * sizeof(uint64_t);
+
+    }
+
+    return planes - out;
+
+}
+
+/// @brief Reverses deltapackCompress(), returning false if the data is too short or corrupt.
+bool deltapackDecompress(const uint8_t* in, long bytes, uint16_t* out, long pixels) {
+
+    long           blocks   = (pixels + DELTAPACK_BLOCK - 1) / DELTAPACK_BLOCK;
+    const uint8_t* planes   = in + blocks;
+    const uint8_t* end      = in + bytes;
+    uint16_t       previous = 0;
+
+    if (bytes < blocks) {
+        return false;
+    }
+
+    for (long b = 0; b < blocks; b++) {
+
+        int width = in[b];
+
+        if (width > 16 || planes + width * sizeof(uint64_t) > end) {
+            return false;
+        }
+
+        uint16_t residuals[DELTAPACK_BLOCK] = {0};
+
+        for (int k = 0; k < width; k++, planes += sizeof(uint64_t)) {
+
+            uint64_t plane;
+            memcpy(&plane, planes, sizeof(plane));
+
+            for (int i = 0; i < DELTAPACK_BLOCK; i++) {
+                residuals[i] |= (uint16_t) (((plane >> i) & 1) << k);
+            }
+
+        }
+
+        long start = b * DELTAPACK_BLOCK;
+        long count = pixels - start < DELTAPACK_BLOCK ? pixels - start : DELTAPACK_BLOCK;
+
+        for (long i = 0; i < count; i++) {
+            previous       = (uint16_t) (previous + ((residuals[i] >> 1) ^ -(residuals[i] & 1)));
+            out[start + i] = previous;
+        }
+
+    }
+
+    return true;
+
+}
+
+/// @brief Whether A3C knows the given compression scheme ("none" or "deltapack").
+bool compressionSupported(string name) {
+    return name == "none" || name == "deltapack";
+}
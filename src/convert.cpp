@@ -0,0 +1,714 @@
+#pragma once
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+    #define A3C_X86
+    #include <immintrin.h>
+    #if defined(_MSC_VER)
+        #include <intrin.h>
+        #define A3C_TARGET(x)
+    #else
+        #define A3C_TARGET(x) __attribute__((target(x)))
+    #endif
+#elif defined(__aarch64__) || defined(__ARM_NEON)
+    #define A3C_NEON
+    #include <arm_neon.h>
+#endif
+
+using namespace std;
+
+/// @brief Pixel encodings produced by the Zyla that the native conversion engine
+/// knows how to turn into Mono16.
+enum PixelEncoding {
+    MONO12,
+    MONO12_PACKED,
+    MONO16,
+    MONO32,
+    UNKNOWN_ENCODING
+};
+
+PixelEncoding encodingFromString(string name) {
+
+    if (name == "Mono12")       return MONO12;
+    if (name == "Mono12Packed") return MONO12_PACKED;
+    if (name == "Mono16")       return MONO16;
+    if (name == "Mono32")       return MONO32;
+
+    return UNKNOWN_ENCODING;
+
+}
+
+string encodingName(PixelEncoding encoding) {
+
+    switch (encoding) {
+        case MONO12:        return "Mono12";
+        case MONO12_PACKED: return "Mono12Packed";
+        case MONO16:        return "Mono16";
+        case MONO32:        return "Mono32";
+        default:            return "Unknown";
+    }
+
+}
+
+/// @brief Number of bytes taken up by one row of the given width, before any
+/// stride padding.
+long encodingRowBytes(PixelEncoding encoding, long width) {
+
+    switch (encoding) {
+        case MONO12_PACKED: return (width * 3 + 1) / 2;
+        case MONO32:        return width * 4;
+        default:            return width * 2;
+    }
+
+}
+
+// Row kernels: each one converts a single row of width pixels, reading at most
+// available bytes from in (the row stride, so reading into the padding is fine)
+
+typedef void (*RowKernel)(const uint8_t* in, uint16_t* out, long width, long available);
+
+// Accumulation kernels: each one adds (or takes away) a single row of width Mono16
+// pixels onto a row of 32-bit totals
+
+typedef void (*SumKernel)(const uint16_t* in, uint32_t* sum, long width);
+
+// Correction kernels: each one works out (in - offset) * gain for count Mono16
+// pixels, writing either Mono16 (rounded to nearest, saturating at 0 and 65535,
+// and fine to do in place) or float32
+
+typedef void (*CorrectKernel)(const uint16_t* in, const float* offset, const float* gain, void* out, long count);
+
+/// @brief Reference Mono12Packed unpacking, as given in the SDK3 manual: each pair
+/// of pixels is packed into three bytes with the low nibbles of both sharing the
+/// middle byte.
+void unpack12Scalar(const uint8_t* in, uint16_t* out, long width, long /* available */) {
+
+    long x = 0;
+
+    for (; x + 1 < width; x += 2, in += 3) {
+        out[x]     = (uint16_t) ((in[0] << 4) | (in[1] & 0x0F));
+        out[x + 1] = (uint16_t) ((in[2] << 4) | (in[1] >> 4));
+    }
+
+    if (x < width) {
+        out[x] = (uint16_t) ((in[0] << 4) | (in[1] & 0x0F));
+    }
+
+}
+
+void narrow32Scalar(const uint8_t* in, uint16_t* out, long width, long /* available */) {
+
+    const uint32_t* pixels = (const uint32_t*) in;
+
+    for (long x = 0; x < width; x++) {
+        out[x] = pixels[x] > 0xFFFF ? 0xFFFF : (uint16_t) pixels[x];
+    }
+
+}
+
+void accumulate16Scalar(const uint16_t* in, uint32_t* sum, long width) {
+
+    for (long x = 0; x < width; x++) {
+        sum[x] += in[x];
+    }
+
+}
+
+void subtract16Scalar(const uint16_t* in, uint32_t* sum, long width) {
+
+    for (long x = 0; x < width; x++) {
+        sum[x] -= in[x];
+    }
+
+}
+
+void correct16Scalar(const uint16_t* in, const float* offset, const float* gain, void* out, long count) {
+
+    uint16_t* pixels = (uint16_t*) out;
+
+    for (long x = 0; x < count; x++) {
+
+        float value = (in[x] - offset[x]) * gain[x];
+              value = value > 0.0f ? value : 0.0f;
+              value = value < 65535.0f ? value : 65535.0f;
+
+        pixels[x] = (uint16_t) lrintf(value);
+
+    }
+
+}
+
+void correctFloatScalar(const uint16_t* in, const float* offset, const float* gain, void* out, long count) {
+
+    float* pixels = (float*) out;
+
+    for (long x = 0; x < count; x++) {
+        pixels[x] = (in[x] - offset[x]) * gain[x];
+    }
+
+}
+
+#if defined(A3C_X86)
+
+// Lays each pixel pair's three bytes out as two 16-bit lanes, (b0, b1) and (b1, b2)
+#define A3C_UNPACK12_SHUFFLE 0, 1, 1, 2, 3, 4, 4, 5, 6, 7, 7, 8, 9, 10, 10, 11
+
+A3C_TARGET("sse4.1")
+void unpack12SSE4(const uint8_t* in, uint16_t* out, long width, long available) {
+
+    const __m128i shuffle = _mm_setr_epi8(A3C_UNPACK12_SHUFFLE);
+    const __m128i high    = _mm_set1_epi16(0x0FF0);
+    const __m128i low     = _mm_set1_epi16(0x000F);
+
+    long x = 0;
+
+    // 8 pixels from 12 bytes per step, but each load reads 16
+    for (; x + 8 <= width && (x / 2) * 3 + 16 <= available; x += 8) {
+
+        __m128i v    = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*) (in + (x / 2) * 3)), shuffle);
+        __m128i even = _mm_or_si128(_mm_and_si128(_mm_slli_epi16(v, 4), high), _mm_and_si128(_mm_srli_epi16(v, 8), low));
+        __m128i odd  = _mm_srli_epi16(v, 4);
+
+        _mm_storeu_si128((__m128i*) (out + x), _mm_blend_epi16(even, odd, 0xAA));
+
+    }
+
+    unpack12Scalar(in + (x / 2) * 3, out + x, width - x, available - (x / 2) * 3);
+
+}
+
+A3C_TARGET("avx2")
+void unpack12AVX2(const uint8_t* in, uint16_t* out, long width, long available) {
+
+    const __m256i shuffle = _mm256_setr_epi8(A3C_UNPACK12_SHUFFLE, A3C_UNPACK12_SHUFFLE);
+    const __m256i high    = _mm256_set1_epi16(0x0FF0);
+    const __m256i low     = _mm256_set1_epi16(0x000F);
+
+    long x = 0;
+
+    // 16 pixels from 24 bytes per step, split over both 128-bit lanes as the
+    // shuffle cannot cross between them, the upper load reads up to byte 28
+    for (; x + 16 <= width && (x / 2) * 3 + 28 <= available; x += 16) {
+
+        const uint8_t* p = in + (x / 2) * 3;
+
+        __m256i v    = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadu_si128((const __m128i*) p)), _mm_loadu_si128((const __m128i*) (p + 12)), 1);
+                v    = _mm256_shuffle_epi8(v, shuffle);
+        __m256i even = _mm256_or_si256(_mm256_and_si256(_mm256_slli_epi16(v, 4), high), _mm256_and_si256(_mm256_srli_epi16(v, 8), low));
+        __m256i odd  = _mm256_srli_epi16(v, 4);
+
+        _mm256_storeu_si256((__m256i*) (out + x), _mm256_blend_epi16(even, odd, 0xAA));
+
+    }
+
+    unpack12Scalar(in + (x / 2) * 3, out + x, width - x, available - (x / 2) * 3);
+
+}
+
+A3C_TARGET("sse4.1")
+void narrow32SSE4(const uint8_t* in, uint16_t* out, long width, long available) {
+
+    const __m128i max = _mm_set1_epi32(0xFFFF);
+
+    long x = 0;
+
+    for (; x + 8 <= width; x += 8) {
+
+        __m128i a = _mm_min_epu32(_mm_loadu_si128((const __m128i*) (in + 4 * x)), max);
+        __m128i b = _mm_min_epu32(_mm_loadu_si128((const __m128i*) (in + 4 * x + 16)), max);
+
+        _mm_storeu_si128((__m128i*) (out + x), _mm_packus_epi32(a, b));
+
+    }
+
+    narrow32Scalar(in + 4 * x, out + x, width - x, available - 4 * x);
+
+}
+
+A3C_TARGET("avx2")
+void narrow32AVX2(const uint8_t* in, uint16_t* out, long width, long available) {
+
+    const __m256i max = _mm256_set1_epi32(0xFFFF);
+
+    long x = 0;
+
+    for (; x + 16 <= width; x += 16) {
+
+        __m256i a = _mm256_min_epu32(_mm256_loadu_si256((const __m256i*) (in + 4 * x)), max);
+        __m256i b = _mm256_min_epu32(_mm256_loadu_si256((const __m256i*) (in + 4 * x + 32)), max);
+
+        // Packing works per 128-bit lane, so put the 64-bit blocks back in order
+        _mm256_storeu_si256((__m256i*) (out + x), _mm256_permute4x64_epi64(_mm256_packus_epi32(a, b), 0xD8));
+
+    }
+
+    narrow32Scalar(in + 4 * x, out + x, width - x, available - 4 * x);
+
+}
+
+A3C_TARGET("sse4.1")
+void accumulate16SSE4(const uint16_t* in, uint32_t* sum, long width) {
+
+    long x = 0;
+
+    for (; x + 8 <= width; x += 8) {
+
+        __m128i v = _mm_loadu_si128((const __m128i*) (in + x));
+        __m128i a = _mm_add_epi32(_mm_loadu_si128((const __m128i*) (sum + x)), _mm_cvtepu16_epi32(v));
+        __m128i b = _mm_add_epi32(_mm_loadu_si128((const __m128i*) (sum + x + 4)), _mm_cvtepu16_epi32(_mm_srli_si128(v, 8)));
+
+        _mm_storeu_si128((__m128i*) (sum + x), a);
+        _mm_storeu_si128((__m128i*) (sum + x + 4), b);
+
+    }
+
+    accumulate16Scalar(in + x, sum + x, width - x);
+
+}
+
+A3C_TARGET("sse4.1")
+void subtract16SSE4(const uint16_t* in, uint32_t* sum, long width) {
+
+    long x = 0;
+
+    for (; x + 8 <= width; x += 8) {
+
+        __m128i v = _mm_loadu_si128((const __m128i*) (in + x));
+        __m128i a = _mm_sub_epi32(_mm_loadu_si128((const __m128i*) (sum + x)), _mm_cvtepu16_epi32(v));
+        __m128i b = _mm_sub_epi32(_mm_loadu_si128((const __m128i*) (sum + x + 4)), _mm_cvtepu16_epi32(_mm_srli_si128(v, 8)));
+
+        _mm_storeu_si128((__m128i*) (sum + x), a);
+        _mm_storeu_si128((__m128i*) (sum + x + 4), b);
+
+    }
+
+    subtract16Scalar(in + x, sum + x, width - x);
+
+}
+
+A3C_TARGET("avx2")
+void accumulate16AVX2(const uint16_t* in, uint32_t* sum, long width) {
+
+    long x = 0;
+
+    for (; x + 16 <= width; x += 16) {
+
+        __m256i a = _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i*) (in + x)));
+        __m256i b = _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i*) (in + x + 8)));
+
+        _mm256_storeu_si256((__m256i*) (sum + x), _mm256_add_epi32(_mm256_loadu_si256((const __m256i*) (sum + x)), a));
+        _mm256_storeu_si256((__m256i*) (sum + x + 8), _mm256_add_epi32(_mm256_loadu_si256((const __m256i*) (sum + x + 8)), b));
+
+    }
+
+    accumulate16Scalar(in + x, sum + x, width - x);
+
+}
+
+A3C_TARGET("avx2")
+void subtract16AVX2(const uint16_t* in, uint32_t* sum, long width) {
+
+    long x = 0;
+
+    for (; x + 16 <= width; x += 16) {
+
+        __m256i a = _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i*) (in + x)));
+        __m256i b = _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i*) (in + x + 8)));
+
+        _mm256_storeu_si256((__m256i*) (sum + x), _mm256_sub_epi32(_mm256_loadu_si256((const __m256i*) (sum + x)), a));
+        _mm256_storeu_si256((__m256i*) (sum + x + 8), _mm256_sub_epi32(_mm256_loadu_si256((const __m256i*) (sum + x + 8)), b));
+
+    }
+
+    subtract16Scalar(in + x, sum + x, width - x);
+
+}
+
+A3C_TARGET("sse4.1")
+void correct16SSE4(const uint16_t* in, const float* offset, const float* gain, void* out, long count) {
+
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 max  = _mm_set1_ps(65535.0f);
+
+    uint16_t* pixels = (uint16_t*) out;
+    long      x      = 0;
+
+    for (; x + 8 <= count; x += 8) {
+
+        __m128i v = _mm_loadu_si128((const __m128i*) (in + x));
+        __m128  a = _mm_mul_ps(_mm_sub_ps(_mm_cvtepi32_ps(_mm_cvtepu16_epi32(v)), _mm_loadu_ps(offset + x)), _mm_loadu_ps(gain + x));
+        __m128  b = _mm_mul_ps(_mm_sub_ps(_mm_cvtepi32_ps(_mm_cvtepu16_epi32(_mm_srli_si128(v, 8))), _mm_loadu_ps(offset + x + 4)), _mm_loadu_ps(gain + x + 4));
+
+        // Clamping before converting keeps anything out of range from wrapping around
+        a = _mm_min_ps(_mm_max_ps(a, zero), max);
+        b = _mm_min_ps(_mm_max_ps(b, zero), max);
+
+        _mm_storeu_si128((__m128i*) (pixels + x), _mm_packus_epi32(_mm_cvtps_epi32(a), _mm_cvtps_epi32(b)));
+
+    }
+
+    correct16Scalar(in + x, offset + x, gain + x, pixels + x, count - x);
+
+}
+
+A3C_TARGET("sse4.1")
+void correctFloatSSE4(const uint16_t* in, const float* offset, const float* gain, void* out, long count) {
+
+    float* pixels = (float*) out;
+    long   x      = 0;
+
+    for (; x + 8 <= count; x += 8) {
+
+        __m128i v = _mm_loadu_si128((const __m128i*) (in + x));
+
+        _mm_storeu_ps(pixels + x, _mm_mul_ps(_mm_sub_ps(_mm_cvtepi32_ps(_mm_cvtepu16_epi32(v)), _mm_loadu_ps(offset + x)), _mm_loadu_ps(gain + x)));
+        _mm_storeu_ps(pixels + x + 4, _mm_mul_ps(_mm_sub_ps(_mm_cvtepi32_ps(_mm_cvtepu16_epi32(_mm_srli_si128(v, 8))), _mm_loadu_ps(offset + x + 4)), _mm_loadu_ps(gain + x + 4)));
+
+    }
+
+    correctFloatScalar(in + x, offset + x, gain + x, pixels + x, count - x);
+
+}
+
+A3C_TARGET("avx2")
+void correct16AVX2(const uint16_t* in, const float* offset, const float* gain, void* out, long count) {
+
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 max  = _mm256_set1_ps(65535.0f);
+
+    uint16_t* pixels = (uint16_t*) out;
+    long      x      = 0;
+
+    for (; x + 8 <= count; x += 8) {
+
+        __m256 v = _mm256_cvtepi32_ps(_mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i*) (in + x))));
+               v = _mm256_mul_ps(_mm256_sub_ps(v, _mm256_loadu_ps(offset + x)), _mm256_loadu_ps(gain + x));
+               v = _mm256_min_ps(_mm256_max_ps(v, zero), max);
+
+        __m256i i = _mm256_cvtps_epi32(v);
+
+        _mm_storeu_si128((__m128i*) (pixels + x), _mm_packus_epi32(_mm256_castsi256_si128(i), _mm256_extracti128_si256(i, 1)));
+
+    }
+
+    correct16Scalar(in + x, offset + x, gain + x, pixels + x, count - x);
+
+}
+
+A3C_TARGET("avx2")
+void correctFloatAVX2(const uint16_t* in, const float* offset, const float* gain, void* out, long count) {
+
+    float* pixels = (float*) out;
+    long   x      = 0;
+
+    for (; x + 8 <= count; x += 8) {
+
+        __m256 v = _mm256_cvtepi32_ps(_mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i*) (in + x))));
+
+        _mm256_storeu_ps(pixels + x, _mm256_mul_ps(_mm256_sub_ps(v, _mm256_loadu_ps(offset + x)), _mm256_loadu_ps(gain + x)));
+
+    }
+
+    correctFloatScalar(in + x, offset + x, gain + x, pixels + x, count - x);
+
+}
+
+#endif
+
+#if defined(A3C_NEON)
+
+void unpack12NEON(const uint8_t* in, uint16_t* out, long width, long available) {
+
+    long x = 0;
+
+    // 32 pixels from 48 bytes per step, de-interleaved into first, middle and last bytes
+    for (; x + 32 <= width; x += 32) {
+
+        uint8x16x3_t bytes = vld3q_u8(in + (x / 2) * 3);
+        uint8x16_t   mid   = bytes.val[1];
+        uint8x16_t   lowN  = vandq_u8(mid, vdupq_n_u8(0x0F));
+        uint8x16_t   highN = vshrq_n_u8(mid, 4);
+
+        uint16x8x2_t first, second;
+
+        first.val[0]  = vorrq_u16(vshll_n_u8(vget_low_u8(bytes.val[0]), 4), vmovl_u8(vget_low_u8(lowN)));
+        first.val[1]  = vorrq_u16(vshll_n_u8(vget_low_u8(bytes.val[2]), 4), vmovl_u8(vget_low_u8(highN)));
+        second.val[0] = vorrq_u16(vshll_n_u8(vget_high_u8(bytes.val[0]), 4), vmovl_u8(vget_high_u8(lowN)));
+        second.val[1] = vorrq_u16(vshll_n_u8(vget_high_u8(bytes.val[2]), 4), vmovl_u8(vget_high_u8(highN)));
+
+        vst2q_u16(out + x, first);
+        vst2q_u16(out + x + 16, second);
+
+    }
+
+    unpack12Scalar(in + (x / 2) * 3, out + x, width - x, available - (x / 2) * 3);
+
+}
+
+void narrow32NEON(const uint8_t* in, uint16_t* out, long width, long available) {
+
+    const uint32_t* pixels = (const uint32_t*) in;
+
+    long x = 0;
+
+    for (; x + 8 <= width; x += 8) {
+        vst1q_u16(out + x, vcombine_u16(vqmovn_u32(vld1q_u32(pixels + x)), vqmovn_u32(vld1q_u32(pixels + x + 4))));
+    }
+
+    narrow32Scalar(in + 4 * x, out + x, width - x, available - 4 * x);
+
+}
+
+void accumulate16NEON(const uint16_t* in, uint32_t* sum, long width) {
+
+    long x = 0;
+
+    for (; x + 8 <= width; x += 8) {
+
+        uint16x8_t v = vld1q_u16(in + x);
+
+        vst1q_u32(sum + x, vaddw_u16(vld1q_u32(sum + x), vget_low_u16(v)));
+        vst1q_u32(sum + x + 4, vaddw_u16(vld1q_u32(sum + x + 4), vget_high_u16(v)));
+
+    }
+
+    accumulate16Scalar(in + x, sum + x, width - x);
+
+}
+
+void subtract16NEON(const uint16_t* in, uint32_t* sum, long width) {
+
+    long x = 0;
+
+    for (; x + 8 <= width; x += 8) {
+
+        uint16x8_t v = vld1q_u16(in + x);
+
+        vst1q_u32(sum + x, vsubw_u16(vld1q_u32(sum + x), vget_low_u16(v)));
+        vst1q_u32(sum + x + 4, vsubw_u16(vld1q_u32(sum + x + 4), vget_high_u16(v)));
+
+    }
+
+    subtract16Scalar(in + x, sum + x, width - x);
+
+}
+
+void correct16NEON(const uint16_t* in, const float* offset, const float* gain, void* out, long count) {
+
+    uint16_t* pixels = (uint16_t*) out;
+    long      x      = 0;
+
+#if defined(__aarch64__)
+
+    const float32x4_t zero = vdupq_n_f32(0.0f);
+    const float32x4_t max  = vdupq_n_f32(65535.0f);
+
+    for (; x + 4 <= count; x += 4) {
+
+        float32x4_t v = vcvtq_f32_u32(vmovl_u16(vld1_u16(in + x)));
+                    v = vmulq_f32(vsubq_f32(v, vld1q_f32(offset + x)), vld1q_f32(gain + x));
+                    v = vminq_f32(vmaxq_f32(v, zero), max);
+
+        vst1_u16(pixels + x, vmovn_u32(vcvtnq_u32_f32(v)));
+
+    }
+
+#endif
+
+    correct16Scalar(in + x, offset + x, gain + x, pixels + x, count - x);
+
+}
+
+void correctFloatNEON(const uint16_t* in, const float* offset, const float* gain, void* out, long count) {
+
+    float* pixels = (float*) out;
+    long   x      = 0;
+
+    for (; x + 4 <= count; x += 4) {
+
+        float32x4_t v = vcvtq_f32_u32(vmovl_u16(vld1_u16(in + x)));
+
+        vst1q_f32(pixels + x, vmulq_f32(vsubq_f32(v, vld1q_f32(offset + x)), vld1q_f32(gain + x)));
+
+    }
+
+    correctFloatScalar(in + x, offset + x, gain + x, pixels + x, count - x);
+
+}
+
+#endif
+
+struct ConversionKernels {
+
+    string        name;
+    RowKernel     unpack12;
+    RowKernel     narrow32;
+    SumKernel     accumulate16;
+    SumKernel     subtract16;
+    CorrectKernel correct16;
+    CorrectKernel correctFloat;
+
+};
+
+bool kernelSupported(string name) {
+
+    if (name == "scalar") {
+        return true;
+    }
+
+#if defined(A3C_X86) && defined(_MSC_VER)
+
+    int info[4];
+    __cpuid(info, 1);
+
+    bool sse4 = (info[2] & (1 << 19)) != 0;
+    bool avx  = (info[2] & (1 << 28)) != 0 && (info[2] & (1 << 27)) != 0 && (_xgetbv(0) & 6) == 6;
+
+    __cpuidex(info, 7, 0);
+
+    if (name == "avx2") return avx && (info[1] & (1 << 5)) != 0;
+    if (name == "sse4") return sse4;
+
+#elif defined(A3C_X86)
+
+    __builtin_cpu_init();
+
+    if (name == "avx2") return __builtin_cpu_supports("avx2");
+    if (name == "sse4") return __builtin_cpu_supports("sse4.1");
+
+#elif defined(A3C_NEON)
+
+    if (name == "neon") return true;
+
+#endif
+
+    return false;
+
+}
+
+/// @brief The table of kernels with the given name, which lives for as long as the
+/// program does so it can be handed out by pointer.
+const ConversionKernels* kernelsFor(string name) {
+
+#if defined(A3C_X86)
+    static const ConversionKernels avx2 = {"avx2", unpack12AVX2, narrow32AVX2, accumulate16AVX2, subtract16AVX2, correct16AVX2, correctFloatAVX2};
+    static const ConversionKernels sse4 = {"sse4", unpack12SSE4, narrow32SSE4, accumulate16SSE4, subtract16SSE4, correct16SSE4, correctFloatSSE4};
+
+    if (name == "avx2") return &avx2;
+    if (name == "sse4") return &sse4;
+#elif defined(A3C_NEON)
+    static const ConversionKernels neon = {"neon", unpack12NEON, narrow32NEON, accumulate16NEON, subtract16NEON, correct16NEON, correctFloatNEON};
+
+    if (name == "neon") return &neon;
+#endif
+
+    static const ConversionKernels scalar = {"scalar", unpack12Scalar, narrow32Scalar, accumulate16Scalar, subtract16Scalar, correct16Scalar, correctFloatScalar};
+
+    return &scalar;
+
+}
+
+/// @brief Which table of kernels is in use, starting with the fastest the CPU we're
+/// running on supports. Only ever swapped for another whole table, atomically, so
+/// workers converting frames while it changes see either the old one or the new.
+atomic<const ConversionKernels*>& kernelTable() {
+
+    static atomic<const ConversionKernels*> active(kernelsFor(
+        kernelSupported("avx2") ? "avx2" : kernelSupported("sse4") ? "sse4" : kernelSupported("neon") ? "neon" : "scalar"
+    ));
+
+    return active;
+
+}
+
+const ConversionKernels& activeKernels() {
+    return *kernelTable().load(memory_order_acquire);
+}
+
+string getConversionKernel() {
+    return activeKernels().name;
+}
+
+/// @brief Overrides the automatically chosen kernels (e.g., "scalar" to compare
+/// against), returning false if the CPU does not support the ones asked for.
+bool setConversionKernel(string name) {
+
+    if (!kernelSupported(name)) {
+        return false;
+    }
+
+    kernelTable().store(kernelsFor(name), memory_order_release);
+
+    return true;
+
+}
+
+/// @brief Converts a frame of the given encoding into contiguous Mono16, dropping
+/// any padding at the end of each row. Mono12 and Mono16 are copied as-is, Mono32
+/// saturates at 65535, and Mono12Packed is unpacked following the layout in the
+/// SDK3 manual so the result matches AT_ConvertBuffer. Returns false, without
+/// touching anything, if the rows don't fit their stride or the stride times the
+/// height doesn't fit the available bytes of the input.
+bool convertToMono16(const uint8_t* in, uint16_t* out, long width, long height, long stride, PixelEncoding encoding, long available) {
+
+    long rowBytes = encodingRowBytes(encoding, width);
+
+    if (width < 0 || height < 0 || stride < rowBytes || stride * height > available) {
+        return false;
+    }
+
+    switch (encoding) {
+
+        case MONO12:
+        case MONO16:
+
+            if (stride == rowBytes) {
+                memcpy(out, in, rowBytes * height);
+                return true;
+            }
+
+            for (long y = 0; y < height; y++) {
+                memcpy(out + y * width, in + y * stride, rowBytes);
+            }
+
+            return true;
+
+        case MONO12_PACKED:
+
+            for (long y = 0; y < height; y++) {
+                activeKernels().unpack12(in + y * stride, out + y * width, width, stride);
+            }
+
+            return true;
+
+        case MONO32:
+
+            for (long y = 0; y < height; y++) {
+                activeKernels().narrow32(in + y * stride, out + y * width, width, stride);
+            }
+
+            return true;
+
+        default:
+            return false;
+
+    }
+
+}
+
+/// @brief Sums rows of contiguous Mono16 pixels into a single row of 32-bit totals,
+/// e.g., to turn one track of a multitrack frame into a spectrum. The totals can't
+/// overflow for anything up to 65537 rows, far more than the sensor has.
+void sumRows(const uint16_t* in, uint32_t* out, long width, long rows) {
+
+    memset(out, 0, width * sizeof(uint32_t));
+
+    for (long y = 0; y < rows; y++) {
+        activeKernels().accumulate16(in + y * width, out, width);
+    }
+
+}
@@ -0,0 +1,149 @@
+#pragma once
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string>
+
+using namespace std;
+
+#define A3C_FILE_MAGIC   "A3CF"
+#define A3C_FILE_VERSION 2
+
+// Values of A3CHeader::compression
+#define A3C_COMPRESSION_NONE      0
+#define A3C_COMPRESSION_DELTAPACK 1
+
+#define A3C_INDEX_MAGIC     "A3CI"
+#define A3C_INDEX_VERSION   1
+#define A3C_INDEX_EXTENSION ".idx"
+
+// When output is split into segments, the manifest sits at the output path plus this
+// extension. It is plain text, one tab-separated line per segment once that segment
+// has been closed (so anything listed in it is complete and safe to read):
+//
+//   segment  path  firstSequence  lastSequence  frames  bytes  firstTimestamp  lastTimestamp
+//
+// after a header line starting with '#'. The path is relative to the manifest.
+#define A3C_MANIFEST_EXTENSION ".manifest"
+#define A3C_MANIFEST_VERSION   1
+
+/// @brief Fixed 64-byte header at the start of every file written by A3C. It is
+/// followed directly by frameCount frames, each one a contiguous block of
+/// width * height little-endian pixels of bytesPerPixel bytes, row by row. The
+/// header is written with frameCount = 0 when the file is opened and re-written
+/// with the real count when the file is closed, so a frameCount of zero on a
+/// non-empty file means the capture did not shut down cleanly (the number of
+/// frames can then be recovered from the file size). If compression is set, each
+/// frame is instead compressed on its own (see compress.cpp), and the index gives
+/// where each one starts and how many bytes it takes up.
+#pragma pack(push, 1)
+struct A3CHeader {
+
+    char     magic[4];
+    uint32_t version;
+    uint32_t headerSize;
+    uint32_t width;
+    uint32_t height;
+    uint32_t bytesPerPixel;
+    char     encoding[16];
+    uint64_t frameCount;
+    uint32_t compression;
+    uint8_t  reserved[12];
+
+    A3CHeader(long width = 0, long height = 0, string encoding = "Mono16") {
+
+        memset(this, 0, sizeof(A3CHeader));
+        memcpy(this->magic, A3C_FILE_MAGIC, 4);
+        strncpy(this->encoding, encoding.c_str(), sizeof(this->encoding) - 1);
+
+        this->version       = A3C_FILE_VERSION;
+        this->headerSize    = sizeof(A3CHeader);
+        this->width         = (uint32_t) width;
+        this->height        = (uint32_t) height;
+        this->bytesPerPixel = encoding == "Mono32" || encoding == "Float32" ? 4 : 2;
+
+    }
+
+    long frameBytes() {
+        return (long) width * height * bytesPerPixel;
+    }
+
+    void write(ostream& output) {
+        output.write((const char*) this, sizeof(A3CHeader));
+    }
+
+};
+#pragma pack(pop)
+
+static_assert(sizeof(A3CHeader) == 64, "A3CHeader must be exactly 64 bytes");
+
+/// @brief Index entry for a single frame: its sequence number, hardware timestamp
+/// (in ticks of the camera's timestamp clock), where its data starts in the data
+/// file, how many bytes it takes up there, and any FRAME_* status flags.
+#pragma pack(push, 1)
+struct A3CIndexRecord {
+
+    uint64_t sequence;
+    uint64_t timestamp;
+    uint64_t offset;
+    uint32_t bytes;
+    uint32_t flags;
+
+};
+#pragma pack(pop)
+
+/// @brief Fixed 32-byte header at the start of the index file written alongside
+/// each data file (at the same path plus A3C_INDEX_EXTENSION). It is followed by
+/// one A3CIndexRecord per frame, so the record for frame N always sits at
+/// headerSize + N * recordSize. The timestamp clock frequency is recorded so
+/// that ticks can be turned into seconds.
+#pragma pack(push, 1)
+struct A3CIndexHeader {
+
+    char     magic[4];
+    uint32_t version;
+    uint32_t headerSize;
+    uint32_t recordSize;
+    uint64_t clockFrequency;
+    uint8_t  reserved[8];
+
+    A3CIndexHeader(long long clockFrequency = 0) {
+
+        memset(this, 0, sizeof(A3CIndexHeader));
+        memcpy(this->magic, A3C_INDEX_MAGIC, 4);
+
+        this->version        = A3C_INDEX_VERSION;
+        this->headerSize     = sizeof(A3CIndexHeader);
+        this->recordSize     = sizeof(A3CIndexRecord);
+        this->clockFrequency = (uint64_t) clockFrequency;
+
+    }
+
+    void write(ostream& output) {
+        output.write((const char*) this, sizeof(A3CIndexHeader));
+    }
+
+};
+#pragma pack(pop)
+
+static_assert(sizeof(A3CIndexHeader) == 32, "A3CIndexHeader must be exactly 32 bytes");
+static_assert(sizeof(A3CIndexRecord) == 32, "A3CIndexRecord must be exactly 32 bytes");
+
+/// @brief Path of one segment of a split output, made by numbering the output path
+/// just before its extension (e.g., data.bin becomes data.000003.bin).
+string segmentPath(string path, int segment) {
+
+    char number[16];
+    snprintf(number, sizeof(number), ".%06d", segment);
+
+    size_t slash = path.find_last_of("/\\");
+    size_t dot   = path.find_last_of('.');
+
+    if (dot == string::npos || (slash != string::npos && dot < slash)) {
+        return path + number;
+    }
+
+    return path.substr(0, dot) + number + path.substr(dot);
+
+}
@@ -0,0 +1,40 @@
+#pragma once
+#include "metadata.cpp"
+#include <chrono>
+
+// Status flags carried by each frame, and recorded against it in the index file
+#define FRAME_NO_METADATA       0x01
+#define FRAME_NO_TIMESTAMP      0x02
+#define FRAME_CONVERSION_FAILED 0x04
+#define FRAME_GAP               0x08
+#define FRAME_LATE              0x10
+#define FRAME_DISCONTINUITY     0x20
+#define FRAME_BAD_LAYOUT        0x40
+
+/// @brief A single frame as it moves through the A3C pipeline. The acquisition
+/// thread fills in the sequence number and raw SDK buffer, the processing stage
+/// adds the converted pixels and the decoded metadata (timestamp, layout), and
+/// the writing stage consumes the lot. If compression is on, the processing stage
+/// replaces the converted pixels with packedBytes of compressed data in packed. Each
+/// stage stamps the time it handed the frame on, so that the time spent in each can
+/// be measured. A frame with a negative sequence number carries no data and marks
+/// the end of the stream.
+struct Frame {
+
+    long            sequence    = -1;
+    unsigned char*  raw         = nullptr;
+    unsigned short* data        = nullptr;
+    unsigned char*  packed      = nullptr;
+    long            packedBytes = 0;
+    int             status      = 0;
+    FrameMetadata   metadata;
+
+    std::chrono::steady_clock::time_point acquired;
+    std::chrono::steady_clock::time_point processed;
+    std::chrono::steady_clock::time_point ordered;
+
+    bool isEnd() {
+        return sequence < 0;
+    }
+
+};
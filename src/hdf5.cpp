@@ -0,0 +1,309 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#if defined(A3C_HAVE_HDF5)
+#include <hdf5.h>
+#endif
+
+using namespace std;
+
+// Number of frames the HDF5 datasets grow by at a time, and that per-frame values are written in
+#define HDF5_GROW_FRAMES 1024
+
+#if defined(A3C_HAVE_HDF5)
+
+/// @brief Writes frames straight into an HDF5 file, laid out as:
+///
+///   /frames      uint16 [N, height, width], chunked one frame (or track) per chunk,
+///                or uint32 for Mono32 (e.g., track spectra) or float32 for Float32
+///   /timestamps  uint64 [N], hardware timestamp of each frame in clock ticks, with
+///                the clock frequency (Hz) as its "clockFrequency" attribute
+///   /sequence    int64  [N], frame number as counted by the acquisition thread
+///   /status      uint32 [N], FRAME_* flags for each frame
+///
+/// Frames are written a chunk at a time with H5Dwrite_chunk(), which skips the
+/// selection and conversion machinery altogether, so this is little more than a
+/// plain write per chunk. The datasets are grown HDF5_GROW_FRAMES at a time and
+/// trimmed to the real number of frames on close().
+class HDF5Output {
+
+    private:
+
+        hid_t file       = -1;
+        hid_t frames     = -1;
+        hid_t timestamps = -1;
+        hid_t sequences  = -1;
+        hid_t statuses   = -1;
+
+        long    width         = 0;
+        long    height        = 0;
+        long    chunkRows     = 0;
+        int     bytesPerPixel = 2;
+        hsize_t count     = 0;
+        hsize_t capacity  = 0;
+        hsize_t flushed   = 0;
+
+        vector<uint64_t> pendingTimestamps;
+        vector<int64_t>  pendingSequences;
+        vector<uint32_t> pendingStatuses;
+
+        string error;
+
+        hid_t createSeries(const char* name, hid_t type) {
+
+            hsize_t dims[1]    = {0};
+            hsize_t maxDims[1] = {H5S_UNLIMITED};
+            hsize_t chunk[1]   = {HDF5_GROW_FRAMES};
+
+            hid_t space      = H5Screate_simple(1, dims, maxDims);
+            hid_t properties = H5Pcreate(H5P_DATASET_CREATE);
+
+            H5Pset_chunk(properties, 1, chunk);
+
+            hid_t dataset = H5Dcreate2(file, name, type, space, H5P_DEFAULT, properties, H5P_DEFAULT);
+
+            H5Pclose(properties);
+            H5Sclose(space);
+
+            return dataset;
+
+        }
+
+        bool grow(hsize_t frameCount) {
+
+            hsize_t frameDims[3]  = {frameCount, (hsize_t) height, (hsize_t) width};
+            hsize_t seriesDims[1] = {frameCount};
+
+            return H5Dset_extent(frames, frameDims) >= 0
+                && H5Dset_extent(timestamps, seriesDims) >= 0
+                && H5Dset_extent(sequences, seriesDims) >= 0
+                && H5Dset_extent(statuses, seriesDims) >= 0;
+
+        }
+
+        bool writeSeries(hid_t dataset, hid_t type, const void* data, hsize_t start, hsize_t length) {
+
+            hsize_t offset[1] = {start};
+            hsize_t size[1]   = {length};
+
+            hid_t fileSpace   = H5Dget_space(dataset);
+            hid_t memorySpace = H5Screate_simple(1, size, nullptr);
+
+            H5Sselect_hyperslab(fileSpace, H5S_SELECT_SET, offset, nullptr, size, nullptr);
+
+            herr_t result = H5Dwrite(dataset, type, memorySpace, fileSpace, H5P_DEFAULT, data);
+
+            H5Sclose(memorySpace);
+            H5Sclose(fileSpace);
+
+            return result >= 0;
+
+        }
+
+        /// @brief Writes out the per-frame values collected since the last time.
+        bool flushSeries() {
+
+            hsize_t length = count - flushed;
+
+            if (length == 0) {
+                return true;
+            }
+
+            bool ok = writeSeries(timestamps, H5T_NATIVE_UINT64, pendingTimestamps.data(), flushed, length)
+                   && writeSeries(sequences, H5T_NATIVE_INT64, pendingSequences.data(), flushed, length)
+                   && writeSeries(statuses, H5T_NATIVE_UINT32, pendingStatuses.data(), flushed, length);
+
+            pendingTimestamps.clear();
+            pendingSequences.clear();
+            pendingStatuses.clear();
+
+            flushed = count;
+
+            return ok;
+
+        }
+
+    public:
+
+        ~HDF5Output() {
+            close();
+        }
+
+        /// @brief Creates the file and its (empty) datasets. Each frame is chunked as
+        /// a whole, unless chunkRows divides it into equal parts (e.g., one per track).
+        bool open(string path, long width, long height, long chunkRows, long long clockFrequency, string encoding = "Mono16") {
+
+            hid_t pixelType = encoding == "Mono32" ? H5T_NATIVE_UINT32 : encoding == "Float32" ? H5T_NATIVE_FLOAT : H5T_NATIVE_UINT16;
+
+            this->width         = width;
+            this->height        = height;
+            this->chunkRows     = chunkRows > 0 && height % chunkRows == 0 ? chunkRows : height;
+            this->bytesPerPixel = (int) H5Tget_size(pixelType);
+            this->count         = 0;
+            this->capacity      = 0;
+            this->flushed       = 0;
+
+            file = H5Fcreate(path.c_str(), H5F_ACC_TRUNC, H5P_DEFAULT, H5P_DEFAULT);
+
+            if (file < 0) {
+                error = "Could not create " + path;
+                return false;
+            }
+
+            hsize_t dims[3]    = {0, (hsize_t) height, (hsize_t) width};
+            hsize_t maxDims[3] = {H5S_UNLIMITED, (hsize_t) height, (hsize_t) width};
+            hsize_t chunk[3]   = {1, (hsize_t) this->chunkRows, (hsize_t) width};
+
+            hid_t space      = H5Screate_simple(3, dims, maxDims);
+            hid_t properties = H5Pcreate(H5P_DATASET_CREATE);
+
+            H5Pset_chunk(properties, 3, chunk);
+
+            frames     = H5Dcreate2(file, "frames", pixelType, space, H5P_DEFAULT, properties, H5P_DEFAULT);
+            timestamps = createSeries("timestamps", H5T_NATIVE_UINT64);
+            sequences  = createSeries("sequence", H5T_NATIVE_INT64);
+            statuses   = createSeries("status", H5T_NATIVE_UINT32);
+
+            H5Pclose(properties);
+            H5Sclose(space);
+
+            if (frames < 0 || timestamps < 0 || sequences < 0 || statuses < 0) {
+                error = "Could not create datasets in " + path;
+                return false;
+            }
+
+            hid_t    scalar    = H5Screate(H5S_SCALAR);
+            hid_t    attribute = H5Acreate2(timestamps, "clockFrequency", H5T_NATIVE_UINT64, scalar, H5P_DEFAULT, H5P_DEFAULT);
+            uint64_t frequency = (uint64_t) clockFrequency;
+
+            H5Awrite(attribute, H5T_NATIVE_UINT64, &frequency);
+            H5Aclose(attribute);
+            H5Sclose(scalar);
+
+            pendingTimestamps.reserve(HDF5_GROW_FRAMES);
+            pendingSequences.reserve(HDF5_GROW_FRAMES);
+            pendingStatuses.reserve(HDF5_GROW_FRAMES);
+
+            return true;
+
+        }
+
+        bool write(const void* data, long sequence, long long timestamp, int status) {
+
+            if (file < 0) {
+                return false;
+            }
+
+            if (count == capacity) {
+
+                if (!flushSeries() || !grow(capacity + HDF5_GROW_FRAMES)) {
+                    error = "Could not extend datasets";
+                    return false;
+                }
+
+                capacity += HDF5_GROW_FRAMES;
+
+            }
+
+            size_t         rowBytes = (size_t) width * bytesPerPixel;
+            const uint8_t* pixels   = (const uint8_t*) data;
+
+            for (long row = 0; row < height; row += chunkRows) {
+
+                hsize_t offset[3] = {count, (hsize_t) row, 0};
+
+                if (H5Dwrite_chunk(frames, H5P_DEFAULT, 0, offset, chunkRows * rowBytes, pixels + row * rowBytes) < 0) {
+                    error = "Could not write frame " + to_string(sequence);
+                    return false;
+                }
+
+            }
+
+            pendingTimestamps.push_back((uint64_t) timestamp);
+            pendingSequences.push_back((int64_t) sequence);
+            pendingStatuses.push_back((uint32_t) status);
+
+            count++;
+
+            return true;
+
+        }
+
+        bool close() {
+
+            if (file < 0) {
+                return true;
+            }
+
+            bool ok = flushSeries() && grow(count);
+
+            H5Dclose(frames);
+            H5Dclose(timestamps);
+            H5Dclose(sequences);
+            H5Dclose(statuses);
+
+            ok = H5Fclose(file) >= 0 && ok;
+
+            file = frames = timestamps = sequences = statuses = -1;
+
+            if (!ok) {
+                error = "Could not finish file";
+            }
+
+            return ok;
+
+        }
+
+        long getCount() {
+            return (long) count;
+        }
+
+        string getError() {
+            return error;
+        }
+
+};
+
+#else
+
+/// @brief Stand-in for when HDF5 support isn't compiled in, which refuses to open anything.
+class HDF5Output {
+
+    public:
+
+        bool open(string path, long width, long height, long chunkRows, long long clockFrequency, string encoding = "Mono16") {
+            return false;
+        }
+
+        bool write(const void* data, long sequence, long long timestamp, int status) {
+            return false;
+        }
+
+        bool close() {
+            return true;
+        }
+
+        long getCount() {
+            return 0;
+        }
+
+        string getError() {
+            return "HDF5 support not compiled in";
+        }
+
+};
+
+#endif
+
+/// @brief Whether HDF5 output was compiled in.
+bool hdf5Available() {
+
+#if defined(A3C_HAVE_HDF5)
+    return true;
+#else
+    return false;
+#endif
+
+}
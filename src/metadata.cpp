@@ -0,0 +1,129 @@
+#pragma once
+#include "convert.cpp"
+#include <cstdint>
+#include <cstring>
+
+// Chunk identifiers used in the metadata appended to each frame by the SDK
+#define METADATA_CID_FRAME      0
+#define METADATA_CID_TICKS      1
+#define METADATA_CID_IRIG       2
+#define METADATA_CID_FRAME_INFO 7
+
+/// @brief Everything the SDK attaches to a frame as metadata, decoded in one go.
+/// Plain data only, so it can be copied around with the frame for nothing.
+struct FrameMetadata {
+
+    bool          valid        = false;
+    bool          hasTimestamp = false;
+    bool          hasFrameInfo = false;
+    bool          hasIRIG      = false;
+    long long     timestamp    = 0;
+    long          width        = 0;
+    long          height       = 0;
+    long          stride       = 0;
+    PixelEncoding encoding     = UNKNOWN_ENCODING;
+    uint64_t      irig         = 0;
+    long          dataBytes    = 0;
+
+};
+
+/// @brief Maps the pixel encoding index used in the FrameInfo chunk.
+PixelEncoding metadataEncoding(uint8_t index) {
+
+    switch (index) {
+        case 0:  return MONO16;
+        case 1:  return MONO12;
+        case 2:  return MONO12_PACKED;
+        case 3:  return MONO32;
+        default: return UNKNOWN_ENCODING;
+    }
+
+}
+
+/// @brief Decodes all metadata chunks of a frame in a single pass, without
+/// allocating. The SDK lays each chunk out as [data][CID (4 bytes)][length (4 bytes)],
+/// where length counts the CID and data, and appends them after the image so they
+/// are walked back from the end of the buffer until the image data chunk itself
+/// (CID 0) is reached. Returns false if the chunks don't add up (e.g., metadata was
+/// not enabled), in which case nothing in the result should be trusted.
+bool parseMetadata(const uint8_t* buffer, long size, FrameMetadata& result) {
+
+    result = FrameMetadata();
+
+    long end = size;
+
+    while (end >= 8) {
+
+        uint32_t length;
+        uint32_t cid;
+
+        memcpy(&length, buffer + end - 4, 4);
+        memcpy(&cid, buffer + end - 8, 4);
+
+        if (length < 4 || (long) length + 4 > end) {
+            return false;
+        }
+
+        const uint8_t* data      = buffer + end - 4 - length;
+        long           dataBytes = length - 4;
+
+        switch (cid) {
+
+            case METADATA_CID_FRAME:
+
+                result.dataBytes = dataBytes;
+                result.valid     = true;
+
+                return true;
+
+            case METADATA_CID_TICKS:
+
+                if (dataBytes >= 8) {
+                    memcpy(&result.timestamp, data, 8);
+                    result.hasTimestamp = true;
+                }
+
+                break;
+
+            case METADATA_CID_IRIG:
+
+                if (dataBytes >= 8) {
+                    memcpy(&result.irig, data, 8);
+                    result.hasIRIG = true;
+                }
+
+                break;
+
+            case METADATA_CID_FRAME_INFO:
+
+                // Stride (16 bits), encoding (8), reserved (8), width (16), height (16)
+                if (dataBytes >= 8) {
+
+                    uint16_t stride, width, height;
+
+                    memcpy(&stride, data, 2);
+                    memcpy(&width, data + 4, 2);
+                    memcpy(&height, data + 6, 2);
+
+                    result.stride       = stride;
+                    result.width        = width;
+                    result.height       = height;
+                    result.encoding     = metadataEncoding(data[2]);
+                    result.hasFrameInfo = true;
+
+                }
+
+                break;
+
+            default:
+                break;
+
+        }
+
+        end -= length + 4;
+
+    }
+
+    return false;
+
+}
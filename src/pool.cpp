@@ -0,0 +1,128 @@
+#pragma once
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+using namespace std;
+
+/// @brief Fixed-size pool of equally sized, 8-byte aligned buffers. All buffers
+/// are carved out of a single allocation made when the pool is (re-)sized, and are
+/// then handed out and returned over and over again, so that no allocation takes
+/// place while frames are being acquired. If every buffer is in use, acquire()
+/// waits for one to be released, which is recorded as a "stall" so that the rest
+/// of the pipeline not keeping up shows up as backpressure rather than memory
+/// usage growing without limit.
+class BufferPool {
+
+    private:
+
+        mutex                   lock;
+        condition_variable      available;
+        unsigned char*          block      = nullptr;
+        vector<unsigned char*>  free;
+        long                    bufferSize = 0;
+        int                     count      = 0;
+        long                    stalls     = 0;
+
+    public:
+
+        ~BufferPool() {
+            delete[] block;
+        }
+
+        void allocate(int numBuffers, long size) {
+
+            lock_guard<mutex> guard(lock);
+
+            // Round each buffer up to a multiple of 8 bytes so every one stays aligned
+            long stride = (size + 7) & ~7L;
+
+            delete[] block;
+
+            block      = new unsigned char[numBuffers * stride + 8];
+            bufferSize = size;
+            count      = numBuffers;
+            stalls     = 0;
+
+            unsigned char* aligned = (unsigned char*) (((uintptr_t) block + 7) & ~((uintptr_t) 7));
+
+            free.clear();
+            free.reserve(numBuffers);
+
+            for (int i = numBuffers - 1; i >= 0; i--) {
+                free.push_back(aligned + i * stride);
+            }
+
+        }
+
+        unsigned char* tryAcquire() {
+
+            lock_guard<mutex> guard(lock);
+
+            // Not a stall: callers only try when they have other buffers to be getting on with
+            if (free.empty()) {
+                return nullptr;
+            }
+
+            unsigned char* buffer = free.back();
+            free.pop_back();
+
+            return buffer;
+
+        }
+
+        unsigned char* acquire(long timeoutMS) {
+
+            unique_lock<mutex> guard(lock);
+
+            if (free.empty()) {
+
+                stalls++;
+
+                if (!available.wait_for(guard, chrono::milliseconds(timeoutMS), [this] { return !free.empty(); })) {
+                    return nullptr;
+                }
+
+            }
+
+            unsigned char* buffer = free.back();
+            free.pop_back();
+
+            return buffer;
+
+        }
+
+        void release(unsigned char* buffer) {
+
+            if (buffer == nullptr) {
+                return;
+            }
+
+            lock_guard<mutex> guard(lock);
+
+            free.push_back(buffer);
+            available.notify_one();
+
+        }
+
+        long getBufferSize() {
+            return bufferSize;
+        }
+
+        int capacity() {
+            return count;
+        }
+
+        int inUse() {
+            lock_guard<mutex> guard(lock);
+            return count - (int) free.size();
+        }
+
+        long getStalls() {
+            lock_guard<mutex> guard(lock);
+            return stalls;
+        }
+
+};
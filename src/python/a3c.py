@@ -0,0 +1,124 @@
+import struct
+import numpy as np
+
+# Layouts of the structures in format.cpp
+HEADER_FORMAT       = "<4sIIIII16sQI12x"
+INDEX_HEADER_FORMAT = "<4sIIIQ8x"
+INDEX_RECORD_DTYPE  = np.dtype([
+    ("sequence",  "<u8"),
+    ("timestamp", "<u8"),
+    ("offset",    "<u8"),
+    ("bytes",     "<u4"),
+    ("flags",     "<u4")
+])
+
+COMPRESSION_NONE      = 0
+COMPRESSION_DELTAPACK = 1
+
+DELTAPACK_BLOCK = 64
+
+
+def deltapackDecompress(data: bytes, width: int, height: int) -> np.ndarray:
+    """Decodes one frame compressed with deltapack (see compress.cpp) into a
+    height x width array of uint16. All blocks with the same bit width are
+    unpacked together, so this is vectorised rather than looping per block."""
+
+    pixels = width * height
+    blocks = -(-pixels // DELTAPACK_BLOCK)
+    buffer = np.frombuffer(data, dtype=np.uint8)
+    widths = buffer[:blocks].astype(np.int64)
+    starts = blocks + np.concatenate(([0], np.cumsum(widths * 8)[:-1]))
+
+    if widths.max(initial=0) > 16 or blocks + widths.sum() * 8 > len(buffer):
+        raise ValueError("Corrupt deltapack frame")
+
+    residuals = np.zeros((blocks, DELTAPACK_BLOCK), dtype=np.uint16)
+
+    for depth in np.unique(widths):
+
+        if depth == 0:
+            continue
+
+        selected = np.nonzero(widths == depth)[0]
+        planes   = buffer[starts[selected, None] + np.arange(depth * 8)].reshape(len(selected), depth, 8)
+        bits     = np.unpackbits(planes, axis=2, bitorder="little").astype(np.uint16)
+
+        residuals[selected] = (bits << np.arange(depth, dtype=np.uint16)[:, None]).sum(axis=1, dtype=np.uint16)
+
+    residuals = residuals.reshape(-1)[:pixels]
+    deltas    = (residuals >> 1) ^ np.negative(residuals & 1)
+
+    return np.cumsum(deltas, dtype=np.uint16).reshape(height, width)
+
+
+class A3CFile:
+    """Reads a file written by A3C (along with its index), compressed or not. Each
+    frame comes back as a height x width array, which for track spectra is one row
+    of uint32 totals per track, and is float32 for frames corrected to Float32."""
+
+    def __init__(self, path: str):
+
+        self._file = open(path, "rb")
+
+        header = struct.unpack(HEADER_FORMAT, self._file.read(struct.calcsize(HEADER_FORMAT)))
+
+        magic, self.version, self.headerSize, self.width, self.height, self.bytesPerPixel, encoding, self.frameCount, self.compression = header
+
+        if magic != b"A3CF":
+            raise ValueError(path + " is not an A3C file")
+
+        self.encoding = encoding.rstrip(b"\0").decode()
+
+        with open(path + ".idx", "rb") as index:
+
+            indexHeader = struct.unpack(INDEX_HEADER_FORMAT, index.read(struct.calcsize(INDEX_HEADER_FORMAT)))
+
+            _, _, indexHeaderSize, recordSize, self.clockFrequency = indexHeader
+
+            index.seek(indexHeaderSize)
+
+            self.records = np.frombuffer(index.read(), dtype=INDEX_RECORD_DTYPE)
+
+        # If the capture didn't shut down cleanly, the index still says what made it to disk
+        if self.frameCount == 0:
+            self.frameCount = len(self.records)
+
+    def __len__(self):
+        return self.frameCount
+
+    def __getitem__(self, n: int) -> np.ndarray:
+        return self.frame(n)
+
+    def __iter__(self):
+
+        for n in range(self.frameCount):
+            yield self.frame(n)
+
+    def frame(self, n: int) -> np.ndarray:
+
+        record = self.records[n]
+
+        self._file.seek(int(record["offset"]))
+
+        data = self._file.read(int(record["bytes"]))
+
+        # Anything compressed was compressed as 16-bit words, whatever its pixels really are
+        if self.compression == COMPRESSION_DELTAPACK:
+            data = deltapackDecompress(data, self.width * self.bytesPerPixel // 2, self.height).tobytes()
+
+        dtype = {"Mono32": "<u4", "Float32": "<f4"}.get(self.encoding, "<u2")
+
+        return np.frombuffer(data, dtype=dtype).reshape(self.height, self.width)
+
+    def timestamps(self) -> np.ndarray:
+        """Hardware timestamp of each frame, in seconds."""
+        return self.records["timestamp"][:self.frameCount] / self.clockFrequency
+
+    def close(self):
+        self._file.close()
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, *args):
+        self.close()
@@ -164,7 +164,19 @@ class ZylaStreamGUI(QWidget):
             else:
                 self._capture.setFrameLimit(-1)
                 
-            self._capture.setOutputPath(self._outputFile.text())
+            # HDF5 is written directly by the capture pipeline rather than converted afterwards
+            if self._useH5Conversion.isChecked():
+
+                if not self._capture.setOutputFormat("hdf5"):
+                    raise Exception("HDF5 output is not available in this build")
+
+                self._capture.setOutputPath(self._h5ConversionOutput.text())
+
+            else:
+
+                self._capture.setOutputFormat("a3c")
+                self._capture.setOutputPath(self._outputFile.text())
+
             self._capture.setVerbose(False)
             
             self._capture.start()
@@ -189,9 +201,6 @@ class ZylaStreamGUI(QWidget):
             while self._capture.isMonitoring():
                 sleep(0.1)
                 
-            if self._useH5Conversion.isChecked():
-                self.convert(self._outputFile.text(), self._h5ConversionOutput.text(), 2048, 8)
-                
                 
         except Exception as e:
             
@@ -214,12 +223,6 @@ class ZylaStreamGUI(QWidget):
             pathField.setText(file[0].path())
         
             
-    def convert(self, input: str, output: str, rowSize: int, noRows: int):
-        
-        self._convertingLabel.setStyleSheet("background: teal; color: white;")
-        self._convertingLabel.setStyleSheet("background: silver; color: white;")
-        
-        
     def updateStatus(self):
         
         try:
@@ -1,3 +1,4 @@
+#pragma once
 #include <mutex>
 #include <deque>
 #include "semaphore.cpp"
@@ -29,10 +30,9 @@ template<typename T> class FIFOQueue {
 
             gate.acquire();
 
-            T item = queue.front();
-
             lock_guard<mutex> guard(lock);
 
+            T item = queue.front();
             queue.pop_front();
             count--;
 
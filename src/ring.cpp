@@ -0,0 +1,216 @@
+#pragma once
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+#define RING_CACHE_LINE 64
+#define RING_SPIN_COUNT 2048
+
+/// @brief Bounded, lock-free, single-producer/single-consumer ring buffer. Exactly
+/// one thread may call push() and exactly one other thread may call pop(). The head
+/// and tail indices live on their own cache lines, and each side keeps a cached copy
+/// of the other side's index so it only touches the shared line when it has to.
+///
+/// When the ring is full (push) or empty (pop), the calling thread spins for a short
+/// while before parking on a condition variable. The other side only takes the
+/// parking mutex if it sees that someone is actually parked, so in the steady state
+/// no locks are taken at all.
+template<typename T> class RingBuffer {
+
+    private:
+
+        // Written by the producer only
+        alignas(RING_CACHE_LINE) atomic<unsigned long> head {0};
+        unsigned long                                  cachedTail = 0;
+        atomic<long>                                   highWatermark {0};
+
+        // Written by the consumer only
+        alignas(RING_CACHE_LINE) atomic<unsigned long> tail {0};
+        unsigned long                                  cachedHead = 0;
+
+        // Shared parking state, only used once spinning has not been enough
+        alignas(RING_CACHE_LINE) atomic<int> parked {0};
+        mutex                                parkLock;
+        condition_variable                   parkCondition;
+
+        vector<T>     slots;
+        unsigned long mask = 0;
+
+        void park(const atomic<unsigned long>& index, unsigned long seen) {
+
+            unique_lock<mutex> guard(parkLock);
+
+            parked++;
+
+            // Re-check once registered as parked so a wake-up cannot be missed, the
+            // timeout is only a safety net
+            if (index.load(memory_order_seq_cst) == seen) {
+                parkCondition.wait_for(guard, chrono::milliseconds(10));
+            }
+
+            parked--;
+
+        }
+
+        void wake() {
+
+            atomic_thread_fence(memory_order_seq_cst);
+
+            if (parked.load(memory_order_relaxed) > 0) {
+                lock_guard<mutex> guard(parkLock);
+                parkCondition.notify_all();
+            }
+
+        }
+
+    public:
+
+        RingBuffer(int capacity = 1024) {
+            resize(capacity);
+        }
+
+        /// @brief Sets the capacity (rounded up to a power of two) and empties the ring.
+        /// Must not be called while either side is in use.
+        void resize(int capacity) {
+
+            unsigned long size = 2;
+
+            while (size < (unsigned long) capacity) {
+                size <<= 1;
+            }
+
+            slots.assign(size, T());
+            mask = size - 1;
+
+            clear();
+
+        }
+
+        bool tryPush(T toPush) {
+
+            unsigned long h = head.load(memory_order_relaxed);
+
+            if (h - cachedTail > mask) {
+
+                cachedTail = tail.load(memory_order_acquire);
+
+                if (h - cachedTail > mask) {
+                    return false;
+                }
+
+            }
+
+            slots[h & mask] = toPush;
+            head.store(h + 1, memory_order_release);
+
+            // The cached tail is usually stale, which only ever overstates the depth, so the
+            // real tail is read only when the watermark looks like it might need raising
+            if ((long) (h + 1 - cachedTail) > highWatermark.load(memory_order_relaxed)) {
+
+                long depth = (long) (h + 1 - tail.load(memory_order_relaxed));
+
+                if (depth > highWatermark.load(memory_order_relaxed)) {
+                    highWatermark.store(depth, memory_order_relaxed);
+                }
+
+            }
+
+            wake();
+
+            return true;
+
+        }
+
+        bool tryPop(T& item) {
+
+            unsigned long t = tail.load(memory_order_relaxed);
+
+            if (t == cachedHead) {
+
+                cachedHead = head.load(memory_order_acquire);
+
+                if (t == cachedHead) {
+                    return false;
+                }
+
+            }
+
+            item = slots[t & mask];
+            tail.store(t + 1, memory_order_release);
+
+            wake();
+
+            return true;
+
+        }
+
+        void push(T toPush) {
+
+            for (int spins = 0; !tryPush(toPush); spins++) {
+
+                if (spins < RING_SPIN_COUNT) {
+                    this_thread::yield();
+                } else {
+                    park(tail, cachedTail);
+                }
+
+            }
+
+        }
+
+        T pop() {
+
+            T item;
+
+            for (int spins = 0; !tryPop(item); spins++) {
+
+                if (spins < RING_SPIN_COUNT) {
+                    this_thread::yield();
+                } else {
+                    park(head, cachedHead);
+                }
+
+            }
+
+            return item;
+
+        }
+
+        void clear() {
+
+            head.store(0);
+            tail.store(0);
+
+            cachedHead    = 0;
+            cachedTail    = 0;
+            highWatermark.store(0);
+
+        }
+
+        int size() {
+
+            unsigned long t = tail.load(memory_order_acquire);
+            unsigned long h = head.load(memory_order_acquire);
+
+            return h > t ? (int) (h - t) : 0;
+
+        }
+
+        int capacity() {
+            return (int) (mask + 1);
+        }
+
+        bool hasWaiting() {
+            return size() > 0;
+        }
+
+        long getHighWatermark() {
+            return highWatermark;
+        }
+
+};
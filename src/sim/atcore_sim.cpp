@@ -0,0 +1,1636 @@
+#include "atcore.h"
+#include "atutility.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+/// Software stand-in for libatcore and libatutility, implementing the entry points
+/// used by this project against a simulated Zyla. Frames are generated by a thread
+/// per camera at the configured FrameRate, in whichever PixelEncoding and AOI are
+/// set, with the same metadata trailer as the real camera, and handed out through
+/// AT_QueueBuffer()/AT_WaitBuffer() as the SDK would.
+///
+/// As well as the usual camera features, each simulated camera has a few extra
+/// ones to control the simulation itself:
+///
+///   SimFreeRun     (Boolean) - generate frames as fast as buffers are queued,
+///                              ignoring FrameRate (timestamps still advance by
+///                              one frame period per frame)
+///   SimFill        (Boolean) - write pixel data into each frame, otherwise only
+///                              the metadata is written
+///   SimMaxFrameRate  (Float) - upper limit on FrameRate
+///   SimDropRate      (Float) - probability of the camera skipping a frame
+///   SimStallRate     (Float) - probability of the camera pausing before a frame
+///   SimStallTime     (Float) - length of each pause, in seconds
+///   SimErrorRate     (Float) - probability of AT_WaitBuffer() failing
+///   SimErrorCode   (Integer) - error code AT_WaitBuffer() fails with
+///   SimDroppedFrames (Integer, read-only) - frames skipped so far, either on
+///                              purpose or because no buffer was queued
+///
+/// Any feature can be given a starting value through an environment variable
+/// named A3C_SIM_<Feature> (e.g., A3C_SIM_FrameRate=5000), and the number of
+/// cameras is set by A3C_SIM_CAMERAS (default 1).
+
+namespace {
+
+enum FeatureType { INTEGER, FLOAT, BOOLEAN, ENUMERATED, STRING, COMMAND };
+
+struct Feature {
+
+    FeatureType     type;
+    AT_64           intValue   = 0;
+    AT_64           intMin     = 0;
+    AT_64           intMax     = 0;
+    double          floatValue = 0;
+    double          floatMin   = 0;
+    double          floatMax   = 0;
+    wstring         text;
+    vector<wstring> options;
+    int             index      = 0;
+    bool            writable   = true;
+    bool            live       = false;
+
+};
+
+struct Track {
+
+    AT_64 start;
+    AT_64 end;
+    bool  binned;
+
+};
+
+struct Completed {
+
+    AT_U8* buffer;
+    int    size;
+    int    error;
+
+};
+
+const int ENCODING_MONO12        = 0;
+const int ENCODING_MONO12_PACKED = 1;
+const int ENCODING_MONO16        = 2;
+const int ENCODING_MONO32        = 3;
+
+const uint32_t CID_FRAME      = 0;
+const uint32_t CID_TICKS      = 1;
+const uint32_t CID_FRAME_INFO = 7;
+
+// Encoding indices as used in the FrameInfo metadata chunk
+const uint8_t INFO_ENCODING[] = {1, 2, 0, 3};
+
+wstring toWide(string text) {
+    return wstring(text.begin(), text.end());
+}
+
+string toNarrow(wstring text) {
+    return string(text.begin(), text.end());
+}
+
+long rowBytes(int encoding, long width) {
+
+    switch (encoding) {
+        case ENCODING_MONO12_PACKED: return (width * 3 + 1) / 2;
+        case ENCODING_MONO32:        return width * 4;
+        default:                     return width * 2;
+    }
+
+}
+
+int encodingIndex(wstring name) {
+
+    if (name == L"Mono12")       return ENCODING_MONO12;
+    if (name == L"Mono12Packed") return ENCODING_MONO12_PACKED;
+    if (name == L"Mono16")       return ENCODING_MONO16;
+    if (name == L"Mono32")       return ENCODING_MONO32;
+
+    return -1;
+
+}
+
+class Camera {
+
+    public:
+
+        mutex                   lock;
+        condition_variable      arrived;
+        map<wstring, Feature>   features;
+        vector<Track>           tracks;
+        deque<AT_U8*>           queued;
+        deque<Completed>        completed;
+        thread                  generator;
+        vector<AT_U8>           pattern;
+        atomic<bool>            acquiring {false};
+        mt19937                 random;
+        long                    generation = 0;
+        AT_64                   clockStart = 0;
+        chrono::steady_clock::time_point clockOrigin = chrono::steady_clock::now();
+
+        Camera(int index) : random(1234 + index) {
+
+            addString(L"CameraModel", "SIMULATOR");
+            addString(L"CameraName", "Andor Zyla (Simulated)");
+            addString(L"SerialNumber", "SIM-" + to_string(10000 + index));
+            addString(L"FirmwareVersion", "0.0.0");
+            addString(L"ControllerID", "SIM");
+            addString(L"InterfaceType", "Simulated");
+
+            addInt(L"SensorWidth", 2560, 2560, 2560, false);
+            addInt(L"SensorHeight", 2160, 2160, 2160, false);
+            addInt(L"AOIWidth", 2560, 1, 2560);
+            addInt(L"AOIHeight", 2160, 1, 2160);
+            addInt(L"AOILeft", 1, 1, 2560);
+            addInt(L"AOITop", 1, 1, 2160);
+            addInt(L"AOIHBin", 1, 1, 8);
+            addInt(L"AOIVBin", 1, 1, 8);
+            addInt(L"AOIStride", 0, 0, 0, false);
+            addInt(L"ImageSizeBytes", 0, 0, 0, false);
+            addInt(L"FrameCount", 1, 1, 1L << 31);
+            addInt(L"AccumulateCount", 1, 1, 2048);
+            addInt(L"Baseline", 100, 100, 100, false);
+            addInt(L"MultitrackCount", 1, 1, 256);
+            addInt(L"MultitrackSelector", 0, 0, 255);
+            addInt(L"MultitrackStart", 1, 1, 2160);
+            addInt(L"MultitrackEnd", 1, 1, 2160);
+            addInt(L"TimestampClock", 0, 0, 1LL << 62, false);
+            addInt(L"TimestampClockFrequency", 100000000, 100000000, 100000000, false);
+            addInt(L"SimErrorCode", AT_ERR_HARDWARE_OVERFLOW, 0, 1000);
+            addInt(L"SimDroppedFrames", 0, 0, 1LL << 62, false);
+
+            addFloat(L"ExposureTime", 0.0001, 0.00001, 30.0);
+            addFloat(L"FrameRate", 100.0, 0.01, 100000.0);
+            addFloat(L"ReadoutTime", 0.01, 0.01, 0.01, false);
+            addFloat(L"RowReadTime", 0.0000045, 0.0000045, 0.0000045, false);
+            addFloat(L"LongExposureTransition", 0.01, 0.01, 0.01, false);
+            addFloat(L"MaxInterfaceTransferRate", 100000.0, 100000.0, 100000.0, false);
+            addFloat(L"SensorTemperature", 20.0, -100.0, 100.0, false);
+            addFloat(L"CoolerPower", 0.0, 0.0, 1.0, false);
+            addFloat(L"BytesPerPixel", 2.0, 1.5, 4.0, false);
+            addFloat(L"PixelWidth", 6.5, 6.5, 6.5, false);
+            addFloat(L"PixelHeight", 6.5, 6.5, 6.5, false);
+            addFloat(L"ExternalTriggerDelay", 0.0, 0.0, 10.0);
+            addFloat(L"SimMaxFrameRate", 100000.0, 0.01, 1e9);
+            addFloat(L"SimDropRate", 0.0, 0.0, 1.0);
+            addFloat(L"SimStallRate", 0.0, 0.0, 1.0);
+            addFloat(L"SimStallTime", 1.0, 0.0, 60.0);
+            addFloat(L"SimErrorRate", 0.0, 0.0, 1.0);
+
+            addBool(L"MetadataEnable", false);
+            addBool(L"MetadataFrame", true);
+            addBool(L"MetadataFrameInfo", false);
+            addBool(L"MetadataTimestamp", false);
+            addBool(L"MultitrackBinned", false);
+            addBool(L"SensorCooling", false);
+            addBool(L"Overlap", false);
+            addBool(L"FastAOIFrameRateEnable", false);
+            addBool(L"VerticallyCentreAOI", false);
+            addBool(L"RollingShutterGlobalClear", false);
+            addBool(L"SpuriousNoiseFilter", true);
+            addBool(L"StaticBlemishCorrection", true);
+            addBool(L"FullAOIControl", true);
+            addBool(L"AlternatingReadoutDirection", false);
+            addBool(L"ScanSpeedControlEnable", false);
+            addBool(L"CameraAcquiring", false, false);
+            addBool(L"CameraPresent", true, false);
+            addBool(L"SimFreeRun", false);
+            addBool(L"SimFill", true);
+
+            addEnum(L"PixelEncoding", {L"Mono12", L"Mono12Packed", L"Mono16", L"Mono32"}, 2);
+            addEnum(L"BitDepth", {L"12 Bit", L"16 Bit"}, 1);
+            addEnum(L"AOILayout", {L"Image", L"Multitrack"}, 0);
+            addEnum(L"AOIBinning", {L"1x1", L"2x2", L"3x3", L"4x4", L"8x8"}, 0);
+            addEnum(L"CycleMode", {L"Fixed", L"Continuous"}, 0);
+            addEnum(L"TriggerMode", {L"Internal", L"Software", L"External", L"External Start", L"External Exposure"}, 0);
+            addEnum(L"ElectronicShutteringMode", {L"Rolling", L"Global"}, 0);
+            addEnum(L"PixelReadoutRate", {L"100 MHz", L"270 MHz"}, 0);
+            addEnum(L"SimplePreAmpGainControl", {L"12-bit (high well capacity)", L"12-bit (low noise)", L"16-bit (low noise & high well capacity)"}, 2);
+            addEnum(L"FanSpeed", {L"Off", L"Low", L"On"}, 2);
+            addEnum(L"ShutterMode", {L"Open", L"Closed", L"Auto"}, 2);
+            addEnum(L"TemperatureStatus", {L"Cooler Off", L"Stabilised", L"Cooling", L"Drift", L"Not Stabilised", L"Fault"}, 0);
+            addEnum(L"TemperatureControl", {L"0.00"}, 0);
+            addEnum(L"SensorReadoutMode", {L"Bottom Up Sequential", L"Bottom Up Simultaneous", L"Centre Out Simultaneous", L"Outside In Simultaneous", L"Top Down Sequential", L"Top Down Simultaneous"}, 2);
+
+            addCommand(L"AcquisitionStart");
+            addCommand(L"AcquisitionStop");
+            addCommand(L"SoftwareTrigger");
+            addCommand(L"TimestampClockReset");
+
+            tracks.assign(256, {1, 1, false});
+
+            // Apply any starting values given through the environment
+            for (auto &entry : features) {
+
+                const char* value = getenv(("A3C_SIM_" + toNarrow(entry.first)).c_str());
+
+                if (value == nullptr) {
+                    continue;
+                }
+
+                Feature &feature = entry.second;
+
+                switch (feature.type) {
+                    case INTEGER:    feature.intValue   = atoll(value); break;
+                    case FLOAT:      feature.floatValue = atof(value); break;
+                    case BOOLEAN:    feature.intValue   = string(value) == "1" || string(value) == "true"; break;
+                    case STRING:     feature.text       = toWide(value); break;
+                    case ENUMERATED:
+                        for (int i = 0; i < (int) feature.options.size(); i++) {
+                            if (feature.options[i] == toWide(value)) feature.index = i;
+                        }
+                        break;
+                    default: break;
+                }
+
+            }
+
+        }
+
+        ~Camera() {
+            stop();
+        }
+
+        void addInt(wstring name, AT_64 value, AT_64 min, AT_64 max, bool writable = true) {
+            Feature f{INTEGER};
+            f.intValue = value; f.intMin = min; f.intMax = max; f.writable = writable;
+            features[name] = f;
+        }
+
+        void addFloat(wstring name, double value, double min, double max, bool writable = true) {
+            Feature f{FLOAT};
+            f.floatValue = value; f.floatMin = min; f.floatMax = max; f.writable = writable;
+            features[name] = f;
+        }
+
+        void addBool(wstring name, bool value, bool writable = true) {
+            Feature f{BOOLEAN};
+            f.intValue = value; f.writable = writable;
+            features[name] = f;
+        }
+
+        void addEnum(wstring name, vector<wstring> options, int index) {
+            Feature f{ENUMERATED};
+            f.options = options; f.index = index;
+            features[name] = f;
+        }
+
+        void addString(wstring name, string value) {
+            Feature f{STRING};
+            f.text = toWide(value); f.writable = false;
+            features[name] = f;
+        }
+
+        void addCommand(wstring name) {
+            features[name] = Feature{COMMAND};
+        }
+
+        // Values that depend on other features, all called with the lock held
+
+        int encoding() {
+            return encodingIndex(features[L"PixelEncoding"].options[features[L"PixelEncoding"].index]);
+        }
+
+        bool multitrack() {
+            return features[L"AOILayout"].options[features[L"AOILayout"].index] == L"Multitrack";
+        }
+
+        AT_64 width() {
+            return features[L"AOIWidth"].intValue;
+        }
+
+        AT_64 height() {
+
+            if (!multitrack()) {
+                return features[L"AOIHeight"].intValue;
+            }
+
+            AT_64 rows = 0;
+
+            for (int i = 0; i < features[L"MultitrackCount"].intValue; i++) {
+                rows += tracks[i].binned ? 1 : tracks[i].end - tracks[i].start + 1;
+            }
+
+            return rows;
+
+        }
+
+        AT_64 stride() {
+            return (rowBytes(encoding(), width()) + 7) & ~7LL;
+        }
+
+        AT_64 metadataBytes() {
+
+            if (!features[L"MetadataEnable"].intValue) {
+                return 0;
+            }
+
+            return 8 + (features[L"MetadataTimestamp"].intValue ? 16 : 0) + (features[L"MetadataFrameInfo"].intValue ? 16 : 0);
+
+        }
+
+        AT_64 imageSizeBytes() {
+            return stride() * height() + metadataBytes();
+        }
+
+        AT_64 ticks() {
+            double seconds = chrono::duration<double>(chrono::steady_clock::now() - clockOrigin).count();
+            return clockStart + (AT_64) (seconds * features[L"TimestampClockFrequency"].intValue);
+        }
+
+        double frameRate() {
+            double max = features[L"SimMaxFrameRate"].floatValue;
+            double set = features[L"FrameRate"].floatValue;
+            return set < max ? set : max;
+        }
+
+        int find(const AT_WC* name, FeatureType type, Feature** feature) {
+
+            if (name == nullptr) {
+                return AT_ERR_NULL_FEATURE;
+            }
+
+            auto found = features.find(name);
+
+            if (found == features.end()) {
+                return AT_ERR_NOTIMPLEMENTED;
+            }
+
+            if (found->second.type != type) {
+                return AT_ERR_NOTIMPLEMENTED;
+            }
+
+            *feature = &found->second;
+
+            return AT_SUCCESS;
+
+        }
+
+        int writable(Feature* feature, const AT_WC* name) {
+
+            bool simulation = wcsncmp(name, L"Sim", 3) == 0;
+
+            if (!feature->writable) {
+                return AT_ERR_READONLY;
+            }
+
+            if (acquiring && !simulation) {
+                return AT_ERR_NOTWRITABLE;
+            }
+
+            return AT_SUCCESS;
+
+        }
+
+        int getInt(const AT_WC* name, AT_64* value) {
+
+            lock_guard<mutex> guard(lock);
+
+            Feature* feature;
+            int      result = find(name, INTEGER, &feature);
+
+            if (result != AT_SUCCESS) {
+                return result;
+            }
+
+            wstring key = name;
+
+            if      (key == L"AOIStride")          *value = stride();
+            else if (key == L"ImageSizeBytes")     *value = imageSizeBytes();
+            else if (key == L"AOIHeight")          *value = height();
+            else if (key == L"TimestampClock")     *value = ticks();
+            else if (key == L"MultitrackStart")    *value = tracks[features[L"MultitrackSelector"].intValue].start;
+            else if (key == L"MultitrackEnd")      *value = tracks[features[L"MultitrackSelector"].intValue].end;
+            else                                   *value = feature->intValue;
+
+            return AT_SUCCESS;
+
+        }
+
+        int setInt(const AT_WC* name, AT_64 value) {
+
+            lock_guard<mutex> guard(lock);
+
+            Feature* feature;
+            int      result = find(name, INTEGER, &feature);
+
+            if (result != AT_SUCCESS || (result = writable(feature, name)) != AT_SUCCESS) {
+                return result;
+            }
+
+            if (value < feature->intMin || value > feature->intMax) {
+                return AT_ERR_OUTOFRANGE;
+            }
+
+            wstring key = name;
+            Track&  track = tracks[features[L"MultitrackSelector"].intValue];
+
+            if      (key == L"MultitrackStart") track.start = value;
+            else if (key == L"MultitrackEnd")   track.end   = value;
+            else                                feature->intValue = value;
+
+            return AT_SUCCESS;
+
+        }
+
+        int getFloat(const AT_WC* name, double* value) {
+
+            lock_guard<mutex> guard(lock);
+
+            Feature* feature;
+            int      result = find(name, FLOAT, &feature);
+
+            if (result != AT_SUCCESS) {
+                return result;
+            }
+
+            wstring key = name;
+
+            if      (key == L"FrameRate")         *value = frameRate();
+            else if (key == L"BytesPerPixel")     *value = (double) rowBytes(encoding(), 2) / 2.0;
+            else if (key == L"SensorTemperature") *value = features[L"SensorCooling"].intValue ? 0.0 : 20.0;
+            else                                  *value = feature->floatValue;
+
+            return AT_SUCCESS;
+
+        }
+
+        int setFloat(const AT_WC* name, double value) {
+
+            lock_guard<mutex> guard(lock);
+
+            Feature* feature;
+            int      result = find(name, FLOAT, &feature);
+
+            if (result != AT_SUCCESS || (result = writable(feature, name)) != AT_SUCCESS) {
+                return result;
+            }
+
+            if (value < feature->floatMin || value > feature->floatMax) {
+                return AT_ERR_OUTOFRANGE;
+            }
+
+            feature->floatValue = value;
+
+            return AT_SUCCESS;
+
+        }
+
+        int getBool(const AT_WC* name, AT_BOOL* value) {
+
+            lock_guard<mutex> guard(lock);
+
+            Feature* feature;
+            int      result = find(name, BOOLEAN, &feature);
+
+            if (result != AT_SUCCESS) {
+                return result;
+            }
+
+            wstring key = name;
+
+            if      (key == L"CameraAcquiring")  *value = acquiring;
+            else if (key == L"MultitrackBinned") *value = tracks[features[L"MultitrackSelector"].intValue].binned;
+            else                                 *value = (AT_BOOL) feature->intValue;
+
+            return AT_SUCCESS;
+
+        }
+
+        int setBool(const AT_WC* name, AT_BOOL value) {
+
+            lock_guard<mutex> guard(lock);
+
+            Feature* feature;
+            int      result = find(name, BOOLEAN, &feature);
+
+            if (result != AT_SUCCESS || (result = writable(feature, name)) != AT_SUCCESS) {
+                return result;
+            }
+
+            if (wstring(name) == L"MultitrackBinned") {
+                tracks[features[L"MultitrackSelector"].intValue].binned = value;
+            } else {
+                feature->intValue = value;
+            }
+
+            return AT_SUCCESS;
+
+        }
+
+        int getEnum(const AT_WC* name, Feature** feature) {
+            lock_guard<mutex> guard(lock);
+            return find(name, ENUMERATED, feature);
+        }
+
+        int setEnumIndex(const AT_WC* name, int index) {
+
+            lock_guard<mutex> guard(lock);
+
+            Feature* feature;
+            int      result = find(name, ENUMERATED, &feature);
+
+            if (result != AT_SUCCESS || (result = writable(feature, name)) != AT_SUCCESS) {
+                return result;
+            }
+
+            if (index < 0 || index >= (int) feature->options.size()) {
+                return AT_ERR_OUTOFRANGE;
+            }
+
+            feature->index = index;
+
+            return AT_SUCCESS;
+
+        }
+
+        int setEnumString(const AT_WC* name, const AT_WC* value) {
+
+            Feature* feature;
+            int      result = getEnum(name, &feature);
+
+            if (result != AT_SUCCESS) {
+                return result;
+            }
+
+            for (int i = 0; i < (int) feature->options.size(); i++) {
+
+                if (feature->options[i] == value) {
+                    return setEnumIndex(name, i);
+                }
+
+            }
+
+            return AT_ERR_INDEXNOTIMPLEMENTED;
+
+        }
+
+        int getString(const AT_WC* name, AT_WC* value, int length) {
+
+            lock_guard<mutex> guard(lock);
+
+            Feature* feature;
+            int      result = find(name, STRING, &feature);
+
+            if (result != AT_SUCCESS) {
+                return result;
+            }
+
+            if ((int) feature->text.size() >= length) {
+                return AT_ERR_EXCEEDEDMAXSTRINGLENGTH;
+            }
+
+            wcscpy(value, feature->text.c_str());
+
+            return AT_SUCCESS;
+
+        }
+
+        int command(const AT_WC* name) {
+
+            Feature* feature;
+
+            {
+                lock_guard<mutex> guard(lock);
+
+                int result = find(name, COMMAND, &feature);
+
+                if (result != AT_SUCCESS) {
+                    return result;
+                }
+            }
+
+            wstring key = name;
+
+            if (key == L"AcquisitionStart") {
+                return start();
+            }
+
+            if (key == L"AcquisitionStop") {
+                stop();
+            }
+
+            if (key == L"TimestampClockReset") {
+                lock_guard<mutex> guard(lock);
+                clockStart  = 0;
+                clockOrigin = chrono::steady_clock::now();
+            }
+
+            return AT_SUCCESS;
+
+        }
+
+        int queue(AT_U8* buffer, int size) {
+
+            lock_guard<mutex> guard(lock);
+
+            if (buffer == nullptr) {
+                return AT_ERR_NULL_QUEUE_PTR;
+            }
+
+            if (((uintptr_t) buffer & 7) != 0) {
+                return AT_ERR_INVALIDALIGNMENT;
+            }
+
+            if (size != imageSizeBytes()) {
+                return AT_ERR_INVALIDSIZE;
+            }
+
+            queued.push_back(buffer);
+
+            return AT_SUCCESS;
+
+        }
+
+        int wait(AT_U8** buffer, int* size, unsigned int timeout) {
+
+            if (buffer == nullptr) {
+                return AT_ERR_NULL_WAIT_PTR;
+            }
+
+            if (size == nullptr) {
+                return AT_ERR_NULL_PTRSIZE;
+            }
+
+            unique_lock<mutex> guard(lock);
+
+            auto ready = [this] { return !completed.empty(); };
+
+            if (timeout == AT_INFINITE) {
+                arrived.wait(guard, ready);
+            } else if (!arrived.wait_for(guard, chrono::milliseconds(timeout), ready)) {
+                return AT_ERR_TIMEDOUT;
+            }
+
+            Completed done = completed.front();
+            completed.pop_front();
+
+            if (done.error != AT_SUCCESS) {
+                return done.error;
+            }
+
+            *buffer = done.buffer;
+            *size   = done.size;
+
+            return AT_SUCCESS;
+
+        }
+
+        int flush() {
+
+            lock_guard<mutex> guard(lock);
+
+            queued.clear();
+            completed.clear();
+            generation++;
+
+            return AT_SUCCESS;
+
+        }
+
+        int start() {
+
+            unique_lock<mutex> guard(lock);
+
+            if (acquiring) {
+                return AT_SUCCESS;
+            }
+
+            // Pre-render the pixel data once, so that each frame only needs a copy
+            long   w      = width();
+            long   h      = height();
+            long   s      = stride();
+            int    enc    = encoding();
+
+            pattern.assign(s * h, 0);
+
+            for (long y = 0; y < h; y++) {
+
+                AT_U8* row = pattern.data() + y * s;
+
+                for (long x = 0; x < w; x++) {
+
+                    uint32_t value = (uint32_t) ((x * 7 + y * 13) & 0x0FFF);
+
+                    switch (enc) {
+
+                        case ENCODING_MONO12_PACKED:
+
+                            if (x % 2 == 0) {
+                                row[(x / 2) * 3]     = (AT_U8) (value >> 4);
+                                row[(x / 2) * 3 + 1] = (AT_U8) ((row[(x / 2) * 3 + 1] & 0xF0) | (value & 0x0F));
+                            } else {
+                                row[(x / 2) * 3 + 2] = (AT_U8) (value >> 4);
+                                row[(x / 2) * 3 + 1] = (AT_U8) ((row[(x / 2) * 3 + 1] & 0x0F) | ((value & 0x0F) << 4));
+                            }
+
+                            break;
+
+                        case ENCODING_MONO32:
+                            memcpy(row + 4 * x, &value, 4);
+                            break;
+
+                        default:
+                            row[2 * x]     = (AT_U8) (value & 0xFF);
+                            row[2 * x + 1] = (AT_U8) (value >> 8);
+                            break;
+
+                    }
+
+                }
+
+            }
+
+            acquiring = true;
+            features[L"SimDroppedFrames"].intValue = 0;
+
+            guard.unlock();
+
+            generator = thread(&Camera::generate, this);
+
+            return AT_SUCCESS;
+
+        }
+
+        void stop() {
+
+            acquiring = false;
+            arrived.notify_all();
+
+            if (generator.joinable()) {
+                generator.join();
+            }
+
+        }
+
+        /// Produces frames until stopped, pacing them against the frame rate unless
+        /// free-running. If generation falls behind (because of a stall, or just not
+        /// being fast enough) it skips frames to catch up, like the real camera would.
+        void generate() {
+
+            unique_lock<mutex> guard(lock);
+
+            bool   freeRun   = features[L"SimFreeRun"].intValue;
+            bool   fill      = features[L"SimFill"].intValue;
+            bool   fixed     = features[L"CycleMode"].options[features[L"CycleMode"].index] == L"Fixed";
+            AT_64  limit     = features[L"FrameCount"].intValue;
+            double period    = 1.0 / frameRate();
+            double dropRate  = features[L"SimDropRate"].floatValue;
+            double stallRate = features[L"SimStallRate"].floatValue;
+            double stallTime = features[L"SimStallTime"].floatValue;
+            double errorRate = features[L"SimErrorRate"].floatValue;
+            int    errorCode = (int) features[L"SimErrorCode"].intValue;
+            double frequency = (double) features[L"TimestampClockFrequency"].intValue;
+            bool   metadata  = features[L"MetadataEnable"].intValue;
+            bool   ticksOn   = features[L"MetadataTimestamp"].intValue;
+            bool   infoOn    = features[L"MetadataFrameInfo"].intValue;
+            long   w         = width();
+            long   h         = height();
+            long   s         = stride();
+            int    enc       = encoding();
+            long   size      = (long) imageSizeBytes();
+            AT_64  firstTick = ticks();
+
+            AT_64& droppedCount = features[L"SimDroppedFrames"].intValue;
+
+            uniform_real_distribution<double> chance(0.0, 1.0);
+
+            auto  origin    = chrono::steady_clock::now();
+            AT_64 frame     = 0;
+            AT_64 delivered = 0;
+
+            while (acquiring && (!fixed || delivered < limit)) {
+
+                // Decide what happens to this frame
+                bool stall = stallRate > 0 && chance(random) < stallRate;
+                bool drop  = dropRate > 0 && chance(random) < dropRate;
+                bool error = errorRate > 0 && chance(random) < errorRate;
+
+                guard.unlock();
+
+                if (stall) {
+
+                    auto until = chrono::steady_clock::now() + chrono::duration<double>(stallTime);
+
+                    while (acquiring && chrono::steady_clock::now() < until) {
+                        this_thread::sleep_for(chrono::milliseconds(1));
+                    }
+
+                }
+
+                if (!freeRun) {
+
+                    auto due = origin + chrono::duration<double>(frame * period);
+                    auto now = chrono::steady_clock::now();
+
+                    // Skip any frames whose time has already passed by more than a period
+                    if (now - due > chrono::duration<double>(period)) {
+
+                        AT_64 behind = (AT_64) (chrono::duration<double>(now - due).count() / period);
+
+                        frame += behind;
+                        guard.lock();
+                        droppedCount += behind;
+                        guard.unlock();
+
+                        due = origin + chrono::duration<double>(frame * period);
+
+                    }
+
+                    this_thread::sleep_until(due);
+
+                }
+
+                AT_64 tick = firstTick + (AT_64) (frame * period * frequency);
+
+                frame++;
+
+                guard.lock();
+
+                if (!acquiring) {
+                    break;
+                }
+
+                // No buffer queued to put the frame into, so it's lost, unless free-running
+                // in which case the frame just waits for one
+                if (queued.empty()) {
+
+                    if (freeRun) {
+                        frame--;
+                        guard.unlock();
+                        this_thread::yield();
+                        guard.lock();
+                    } else {
+                        droppedCount++;
+                    }
+
+                    continue;
+
+                }
+
+                if (drop) {
+                    droppedCount++;
+                    continue;
+                }
+
+                if (error) {
+                    completed.push_back({nullptr, 0, errorCode});
+                    arrived.notify_all();
+                    continue;
+                }
+
+                AT_U8* buffer = queued.front();
+                long   gen    = generation;
+
+                queued.pop_front();
+                guard.unlock();
+
+                if (fill) {
+                    memcpy(buffer, pattern.data(), pattern.size());
+                }
+
+                if (metadata) {
+
+                    AT_U8*   end   = buffer + s * h;
+                    uint32_t cid;
+                    uint32_t length;
+
+                    cid    = CID_FRAME;
+                    length = (uint32_t) (s * h + 4);
+                    memcpy(end, &cid, 4);
+                    memcpy(end + 4, &length, 4);
+                    end += 8;
+
+                    if (ticksOn) {
+                        cid    = CID_TICKS;
+                        length = 12;
+                        memcpy(end, &tick, 8);
+                        memcpy(end + 8, &cid, 4);
+                        memcpy(end + 12, &length, 4);
+                        end += 16;
+                    }
+
+                    if (infoOn) {
+
+                        uint16_t stride16 = (uint16_t) s;
+                        uint16_t width16  = (uint16_t) w;
+                        uint16_t height16 = (uint16_t) h;
+
+                        cid    = CID_FRAME_INFO;
+                        length = 12;
+
+                        memcpy(end, &stride16, 2);
+                        end[2] = INFO_ENCODING[enc];
+                        end[3] = 0;
+                        memcpy(end + 4, &width16, 2);
+                        memcpy(end + 6, &height16, 2);
+                        memcpy(end + 8, &cid, 4);
+                        memcpy(end + 12, &length, 4);
+
+                    }
+
+                }
+
+                guard.lock();
+
+                // If the buffers were flushed while we were filling this one, it's no longer ours
+                if (gen == generation) {
+                    completed.push_back({buffer, (int) size, AT_SUCCESS});
+                    arrived.notify_all();
+                    delivered++;
+                }
+
+            }
+
+            acquiring = false;
+
+        }
+
+};
+
+mutex               libraryLock;
+map<AT_H, Camera*>  cameras;
+bool                initialised = false;
+int                 cameraCount = 1;
+
+Camera* camera(AT_H handle) {
+
+    lock_guard<mutex> guard(libraryLock);
+
+    auto found = cameras.find(handle);
+
+    return found == cameras.end() ? nullptr : found->second;
+
+}
+
+// Scalar reference conversion into Mono16, independent of the project's own engine
+int convert(AT_U8* in, AT_U8* out, AT_64 width, AT_64 height, AT_64 stride, int encoding) {
+
+    uint16_t* pixels = (uint16_t*) out;
+
+    for (AT_64 y = 0; y < height; y++) {
+
+        AT_U8* row = in + y * stride;
+
+        for (AT_64 x = 0; x < width; x++) {
+
+            uint16_t value;
+
+            switch (encoding) {
+
+                case ENCODING_MONO12_PACKED:
+
+                    if (x % 2 == 0) {
+                        value = (uint16_t) ((row[(x / 2) * 3] << 4) | (row[(x / 2) * 3 + 1] & 0x0F));
+                    } else {
+                        value = (uint16_t) ((row[(x / 2) * 3 + 2] << 4) | (row[(x / 2) * 3 + 1] >> 4));
+                    }
+
+                    break;
+
+                case ENCODING_MONO32: {
+                    uint32_t wide;
+                    memcpy(&wide, row + 4 * x, 4);
+                    value = wide > 0xFFFF ? 0xFFFF : (uint16_t) wide;
+                    break;
+                }
+
+                default:
+                    memcpy(&value, row + 2 * x, 2);
+                    break;
+
+            }
+
+            pixels[y * width + x] = value;
+
+        }
+
+    }
+
+    return AT_SUCCESS;
+
+}
+
+// Finds a metadata chunk by walking back from the end of the buffer
+AT_U8* chunk(AT_U8* buffer, AT_64 size, uint32_t wanted) {
+
+    AT_64 end = size;
+
+    while (end >= 8) {
+
+        uint32_t length;
+        uint32_t cid;
+
+        memcpy(&length, buffer + end - 4, 4);
+        memcpy(&cid, buffer + end - 8, 4);
+
+        if (length < 4 || (AT_64) length + 4 > end) {
+            return nullptr;
+        }
+
+        if (cid == wanted) {
+            return buffer + end - 4 - length;
+        }
+
+        if (cid == CID_FRAME) {
+            return nullptr;
+        }
+
+        end -= length + 4;
+
+    }
+
+    return nullptr;
+
+}
+
+int frameInfo(AT_U8* buffer, AT_64 size, AT_64* width, AT_64* height, AT_64* stride, int* encoding) {
+
+    AT_U8* info = chunk(buffer, size, CID_FRAME_INFO);
+
+    if (info == nullptr) {
+        return AT_ERR_NODATA;
+    }
+
+    uint16_t s, w, h;
+
+    memcpy(&s, info, 2);
+    memcpy(&w, info + 4, 2);
+    memcpy(&h, info + 6, 2);
+
+    *width  = w;
+    *height = h;
+    *stride = s;
+
+    for (int i = 0; i < 4; i++) {
+
+        if (INFO_ENCODING[i] == info[2]) {
+            *encoding = i;
+        }
+
+    }
+
+    return AT_SUCCESS;
+
+}
+
+}
+
+extern "C" {
+
+int AT_EXP_CONV AT_InitialiseLibrary() {
+
+    lock_guard<mutex> guard(libraryLock);
+
+    if (!initialised) {
+        const char* count = getenv("A3C_SIM_CAMERAS");
+        cameraCount = count != nullptr ? atoi(count) : 1;
+        initialised = true;
+    }
+
+    return AT_SUCCESS;
+
+}
+
+int AT_EXP_CONV AT_FinaliseLibrary() {
+
+    lock_guard<mutex> guard(libraryLock);
+
+    for (auto &entry : cameras) {
+        delete entry.second;
+    }
+
+    cameras.clear();
+    initialised = false;
+
+    return AT_SUCCESS;
+
+}
+
+int AT_EXP_CONV AT_Open(int CameraIndex, AT_H *Hndl) {
+
+    lock_guard<mutex> guard(libraryLock);
+
+    if (!initialised) {
+        return AT_ERR_NOTINITIALISED;
+    }
+
+    if (CameraIndex < 0 || CameraIndex >= cameraCount) {
+        return AT_ERR_DEVICENOTFOUND;
+    }
+
+    AT_H handle = 100 + CameraIndex;
+
+    if (cameras.count(handle) > 0) {
+        return AT_ERR_DEVICEINUSE;
+    }
+
+    cameras[handle] = new Camera(CameraIndex);
+    *Hndl           = handle;
+
+    return AT_SUCCESS;
+
+}
+
+int AT_EXP_CONV AT_OpenDevice(const AT_WC* Device, AT_H *Hndl) {
+    return AT_ERR_NOTIMPLEMENTED;
+}
+
+int AT_EXP_CONV AT_Close(AT_H Hndl) {
+
+    Camera* cam = camera(Hndl);
+
+    if (cam == nullptr) {
+        return AT_ERR_INVALIDHANDLE;
+    }
+
+    {
+        lock_guard<mutex> guard(libraryLock);
+        cameras.erase(Hndl);
+    }
+
+    delete cam;
+
+    return AT_SUCCESS;
+
+}
+
+int AT_EXP_CONV AT_RegisterFeatureCallback(AT_H Hndl, const AT_WC* Feature, FeatureCallback EvCallback, void* Context) {
+    return AT_ERR_NOTIMPLEMENTED;
+}
+
+int AT_EXP_CONV AT_UnregisterFeatureCallback(AT_H Hndl, const AT_WC* Feature, FeatureCallback EvCallback, void* Context) {
+    return AT_ERR_NOTIMPLEMENTED;
+}
+
+int AT_EXP_CONV AT_IsImplemented(AT_H Hndl, const AT_WC* Feature, AT_BOOL* Implemented) {
+
+    Camera* cam = camera(Hndl);
+
+    if (cam == nullptr) {
+        return AT_ERR_INVALIDHANDLE;
+    }
+
+    lock_guard<mutex> guard(cam->lock);
+    *Implemented = cam->features.count(Feature) > 0;
+
+    return AT_SUCCESS;
+
+}
+
+int AT_EXP_CONV AT_IsReadable(AT_H Hndl, const AT_WC* Feature, AT_BOOL* Readable) {
+    return AT_IsImplemented(Hndl, Feature, Readable);
+}
+
+int AT_EXP_CONV AT_IsWritable(AT_H Hndl, const AT_WC* Feature, AT_BOOL* Writable) {
+
+    Camera* cam = camera(Hndl);
+
+    if (cam == nullptr) {
+        return AT_ERR_INVALIDHANDLE;
+    }
+
+    lock_guard<mutex> guard(cam->lock);
+
+    auto found = cam->features.find(Feature);
+
+    *Writable = found != cam->features.end() && found->second.writable && !cam->acquiring;
+
+    return AT_SUCCESS;
+
+}
+
+int AT_EXP_CONV AT_IsReadOnly(AT_H Hndl, const AT_WC* Feature, AT_BOOL* ReadOnly) {
+
+    Camera* cam = camera(Hndl);
+
+    if (cam == nullptr) {
+        return AT_ERR_INVALIDHANDLE;
+    }
+
+    lock_guard<mutex> guard(cam->lock);
+
+    auto found = cam->features.find(Feature);
+
+    *ReadOnly = found != cam->features.end() && !found->second.writable;
+
+    return AT_SUCCESS;
+
+}
+
+int AT_EXP_CONV AT_SetInt(AT_H Hndl, const AT_WC* Feature, AT_64 Value) {
+    Camera* cam = camera(Hndl);
+    return cam == nullptr ? AT_ERR_INVALIDHANDLE : cam->setInt(Feature, Value);
+}
+
+int AT_EXP_CONV AT_GetInt(AT_H Hndl, const AT_WC* Feature, AT_64* Value) {
+
+    if (Hndl == AT_HANDLE_SYSTEM) {
+
+        if (wstring(Feature) == L"DeviceCount") {
+            *Value = cameraCount;
+            return AT_SUCCESS;
+        }
+
+        return AT_ERR_NOTIMPLEMENTED;
+
+    }
+
+    Camera* cam = camera(Hndl);
+    return cam == nullptr ? AT_ERR_INVALIDHANDLE : cam->getInt(Feature, Value);
+
+}
+
+int AT_EXP_CONV AT_GetIntMax(AT_H Hndl, const AT_WC* Feature, AT_64* MaxValue) {
+
+    Camera* cam = camera(Hndl);
+
+    if (cam == nullptr) {
+        return AT_ERR_INVALIDHANDLE;
+    }
+
+    lock_guard<mutex> guard(cam->lock);
+
+    ::Feature* feature;
+    int        result = cam->find(Feature, INTEGER, &feature);
+
+    if (result == AT_SUCCESS) {
+        *MaxValue = feature->writable ? feature->intMax : 0;
+    }
+
+    return result;
+
+}
+
+int AT_EXP_CONV AT_GetIntMin(AT_H Hndl, const AT_WC* Feature, AT_64* MinValue) {
+
+    Camera* cam = camera(Hndl);
+
+    if (cam == nullptr) {
+        return AT_ERR_INVALIDHANDLE;
+    }
+
+    lock_guard<mutex> guard(cam->lock);
+
+    ::Feature* feature;
+    int        result = cam->find(Feature, INTEGER, &feature);
+
+    if (result == AT_SUCCESS) {
+        *MinValue = feature->intMin;
+    }
+
+    return result;
+
+}
+
+int AT_EXP_CONV AT_SetFloat(AT_H Hndl, const AT_WC* Feature, double Value) {
+    Camera* cam = camera(Hndl);
+    return cam == nullptr ? AT_ERR_INVALIDHANDLE : cam->setFloat(Feature, Value);
+}
+
+int AT_EXP_CONV AT_GetFloat(AT_H Hndl, const AT_WC* Feature, double* Value) {
+    Camera* cam = camera(Hndl);
+    return cam == nullptr ? AT_ERR_INVALIDHANDLE : cam->getFloat(Feature, Value);
+}
+
+int AT_EXP_CONV AT_GetFloatMax(AT_H Hndl, const AT_WC* Feature, double* MaxValue) {
+
+    Camera* cam = camera(Hndl);
+
+    if (cam == nullptr) {
+        return AT_ERR_INVALIDHANDLE;
+    }
+
+    lock_guard<mutex> guard(cam->lock);
+
+    ::Feature* feature;
+    int        result = cam->find(Feature, FLOAT, &feature);
+
+    if (result == AT_SUCCESS) {
+        *MaxValue = feature->floatMax;
+    }
+
+    return result;
+
+}
+
+int AT_EXP_CONV AT_GetFloatMin(AT_H Hndl, const AT_WC* Feature, double* MinValue) {
+
+    Camera* cam = camera(Hndl);
+
+    if (cam == nullptr) {
+        return AT_ERR_INVALIDHANDLE;
+    }
+
+    lock_guard<mutex> guard(cam->lock);
+
+    ::Feature* feature;
+    int        result = cam->find(Feature, FLOAT, &feature);
+
+    if (result == AT_SUCCESS) {
+        *MinValue = feature->floatMin;
+    }
+
+    return result;
+
+}
+
+int AT_EXP_CONV AT_SetBool(AT_H Hndl, const AT_WC* Feature, AT_BOOL Value) {
+    Camera* cam = camera(Hndl);
+    return cam == nullptr ? AT_ERR_INVALIDHANDLE : cam->setBool(Feature, Value);
+}
+
+int AT_EXP_CONV AT_GetBool(AT_H Hndl, const AT_WC* Feature, AT_BOOL* Value) {
+    Camera* cam = camera(Hndl);
+    return cam == nullptr ? AT_ERR_INVALIDHANDLE : cam->getBool(Feature, Value);
+}
+
+int AT_EXP_CONV AT_SetEnumIndex(AT_H Hndl, const AT_WC* Feature, int Value) {
+    Camera* cam = camera(Hndl);
+    return cam == nullptr ? AT_ERR_INVALIDHANDLE : cam->setEnumIndex(Feature, Value);
+}
+
+int AT_EXP_CONV AT_SetEnumString(AT_H Hndl, const AT_WC* Feature, const AT_WC* String) {
+    Camera* cam = camera(Hndl);
+    return cam == nullptr ? AT_ERR_INVALIDHANDLE : cam->setEnumString(Feature, String);
+}
+
+int AT_EXP_CONV AT_GetEnumIndex(AT_H Hndl, const AT_WC* Feature, int* Value) {
+
+    Camera* cam = camera(Hndl);
+
+    if (cam == nullptr) {
+        return AT_ERR_INVALIDHANDLE;
+    }
+
+    ::Feature* feature;
+    int        result = cam->getEnum(Feature, &feature);
+
+    if (result == AT_SUCCESS) {
+        *Value = feature->index;
+    }
+
+    return result;
+
+}
+
+int AT_EXP_CONV AT_GetEnumCount(AT_H Hndl, const AT_WC* Feature, int* Count) {
+
+    Camera* cam = camera(Hndl);
+
+    if (cam == nullptr) {
+        return AT_ERR_INVALIDHANDLE;
+    }
+
+    ::Feature* feature;
+    int        result = cam->getEnum(Feature, &feature);
+
+    if (result == AT_SUCCESS) {
+        *Count = (int) feature->options.size();
+    }
+
+    return result;
+
+}
+
+int AT_EXP_CONV AT_IsEnumIndexAvailable(AT_H Hndl, const AT_WC* Feature, int Index, AT_BOOL* Available) {
+
+    int count;
+    int result = AT_GetEnumCount(Hndl, Feature, &count);
+
+    if (result == AT_SUCCESS) {
+        *Available = Index >= 0 && Index < count;
+    }
+
+    return result;
+
+}
+
+int AT_EXP_CONV AT_IsEnumIndexImplemented(AT_H Hndl, const AT_WC* Feature, int Index, AT_BOOL* Implemented) {
+    return AT_IsEnumIndexAvailable(Hndl, Feature, Index, Implemented);
+}
+
+int AT_EXP_CONV AT_GetEnumStringByIndex(AT_H Hndl, const AT_WC* Feature, int Index, AT_WC* String, int StringLength) {
+
+    Camera* cam = camera(Hndl);
+
+    if (cam == nullptr) {
+        return AT_ERR_INVALIDHANDLE;
+    }
+
+    ::Feature* feature;
+    int        result = cam->getEnum(Feature, &feature);
+
+    if (result != AT_SUCCESS) {
+        return result;
+    }
+
+    if (Index < 0 || Index >= (int) feature->options.size()) {
+        return AT_ERR_OUTOFRANGE;
+    }
+
+    if ((int) feature->options[Index].size() >= StringLength) {
+        return AT_ERR_EXCEEDEDMAXSTRINGLENGTH;
+    }
+
+    wcscpy(String, feature->options[Index].c_str());
+
+    return AT_SUCCESS;
+
+}
+
+// The older "Enumerated" names behave exactly as their "Enum" equivalents
+
+int AT_EXP_CONV AT_SetEnumerated(AT_H Hndl, const AT_WC* Feature, int Value) {
+    return AT_SetEnumIndex(Hndl, Feature, Value);
+}
+
+int AT_EXP_CONV AT_SetEnumeratedString(AT_H Hndl, const AT_WC* Feature, const AT_WC* String) {
+    return AT_SetEnumString(Hndl, Feature, String);
+}
+
+int AT_EXP_CONV AT_GetEnumerated(AT_H Hndl, const AT_WC* Feature, int* Value) {
+    return AT_GetEnumIndex(Hndl, Feature, Value);
+}
+
+int AT_EXP_CONV AT_GetEnumeratedCount(AT_H Hndl, const AT_WC* Feature, int* Count) {
+    return AT_GetEnumCount(Hndl, Feature, Count);
+}
+
+int AT_EXP_CONV AT_IsEnumeratedIndexAvailable(AT_H Hndl, const AT_WC* Feature, int Index, AT_BOOL* Available) {
+    return AT_IsEnumIndexAvailable(Hndl, Feature, Index, Available);
+}
+
+int AT_EXP_CONV AT_IsEnumeratedIndexImplemented(AT_H Hndl, const AT_WC* Feature, int Index, AT_BOOL* Implemented) {
+    return AT_IsEnumIndexImplemented(Hndl, Feature, Index, Implemented);
+}
+
+int AT_EXP_CONV AT_GetEnumeratedString(AT_H Hndl, const AT_WC* Feature, int Index, AT_WC* String, int StringLength) {
+    return AT_GetEnumStringByIndex(Hndl, Feature, Index, String, StringLength);
+}
+
+int AT_EXP_CONV AT_Command(AT_H Hndl, const AT_WC* Feature) {
+    Camera* cam = camera(Hndl);
+    return cam == nullptr ? AT_ERR_INVALIDHANDLE : cam->command(Feature);
+}
+
+int AT_EXP_CONV AT_SetString(AT_H Hndl, const AT_WC* Feature, const AT_WC* String) {
+    return AT_ERR_READONLY;
+}
+
+int AT_EXP_CONV AT_GetString(AT_H Hndl, const AT_WC* Feature, AT_WC* String, int StringLength) {
+
+    if (Hndl == AT_HANDLE_SYSTEM) {
+
+        if (wstring(Feature) == L"SoftwareVersion") {
+            wcsncpy(String, L"0.0.0 (Simulated)", StringLength);
+            return AT_SUCCESS;
+        }
+
+        return AT_ERR_NOTIMPLEMENTED;
+
+    }
+
+    Camera* cam = camera(Hndl);
+    return cam == nullptr ? AT_ERR_INVALIDHANDLE : cam->getString(Feature, String, StringLength);
+
+}
+
+int AT_EXP_CONV AT_GetStringMaxLength(AT_H Hndl, const AT_WC* Feature, int* MaxStringLength) {
+    *MaxStringLength = 256;
+    return AT_SUCCESS;
+}
+
+int AT_EXP_CONV AT_QueueBuffer(AT_H Hndl, AT_U8* Ptr, int PtrSize) {
+    Camera* cam = camera(Hndl);
+    return cam == nullptr ? AT_ERR_INVALIDHANDLE : cam->queue(Ptr, PtrSize);
+}
+
+int AT_EXP_CONV AT_WaitBuffer(AT_H Hndl, AT_U8** Ptr, int* PtrSize, unsigned int Timeout) {
+    Camera* cam = camera(Hndl);
+    return cam == nullptr ? AT_ERR_INVALIDHANDLE : cam->wait(Ptr, PtrSize, Timeout);
+}
+
+int AT_EXP_CONV AT_Flush(AT_H Hndl) {
+    Camera* cam = camera(Hndl);
+    return cam == nullptr ? AT_ERR_INVALIDHANDLE : cam->flush();
+}
+
+int AT_EXP_CONV AT_InitialiseUtilityLibrary() {
+    return AT_SUCCESS;
+}
+
+int AT_EXP_CONV AT_FinaliseUtilityLibrary() {
+    return AT_SUCCESS;
+}
+
+int AT_EXP_CONV AT_ConvertBuffer(AT_U8* inputBuffer, AT_U8* outputBuffer, AT_64 width, AT_64 height, AT_64 stride, const AT_WC * inputPixelEncoding, const AT_WC * outputPixelEncoding) {
+
+    int encoding = encodingIndex(inputPixelEncoding);
+
+    if (encoding < 0 || wstring(outputPixelEncoding) != L"Mono16") {
+        return AT_ERR_NOTIMPLEMENTED;
+    }
+
+    return convert(inputBuffer, outputBuffer, width, height, stride, encoding);
+
+}
+
+int AT_EXP_CONV AT_ConvertBufferUsingMetadata(AT_U8* inputBuffer, AT_U8* outputBuffer, AT_64 imagesizebytes, const AT_WC * outputPixelEncoding) {
+
+    AT_64 width, height, stride;
+    int   encoding;
+    int   result = frameInfo(inputBuffer, imagesizebytes, &width, &height, &stride, &encoding);
+
+    if (result != AT_SUCCESS) {
+        return result;
+    }
+
+    if (wstring(outputPixelEncoding) != L"Mono16") {
+        return AT_ERR_NOTIMPLEMENTED;
+    }
+
+    return convert(inputBuffer, outputBuffer, width, height, stride, encoding);
+
+}
+
+int AT_EXP_CONV AT_GetWidthFromMetadata(AT_U8* inputBuffer, AT_64 imagesizebytes, AT_64& width) {
+    AT_64 height, stride;
+    int   encoding;
+    return frameInfo(inputBuffer, imagesizebytes, &width, &height, &stride, &encoding);
+}
+
+int AT_EXP_CONV AT_GetHeightFromMetadata(AT_U8* inputBuffer, AT_64 imagesizebytes, AT_64& height) {
+    AT_64 width, stride;
+    int   encoding;
+    return frameInfo(inputBuffer, imagesizebytes, &width, &height, &stride, &encoding);
+}
+
+int AT_EXP_CONV AT_GetStrideFromMetadata(AT_U8* inputBuffer, AT_64 imagesizebytes, AT_64& stride) {
+    AT_64 width, height;
+    int   encoding;
+    return frameInfo(inputBuffer, imagesizebytes, &width, &height, &stride, &encoding);
+}
+
+int AT_EXP_CONV AT_GetPixelEncodingFromMetadata(AT_U8* inputBuffer, AT_64 imagesizebytes, AT_WC* pixelEncoding, AT_U8 pixelEncodingSize) {
+
+    const AT_WC* names[] = {L"Mono12", L"Mono12Packed", L"Mono16", L"Mono32"};
+
+    AT_64 width, height, stride;
+    int   encoding;
+    int   result = frameInfo(inputBuffer, imagesizebytes, &width, &height, &stride, &encoding);
+
+    if (result == AT_SUCCESS) {
+        wcsncpy(pixelEncoding, names[encoding], pixelEncodingSize);
+    }
+
+    return result;
+
+}
+
+int AT_EXP_CONV AT_GetTimeStampFromMetadata(AT_U8* inputBuffer, AT_64 imagesizebytes, AT_64& timeStamp) {
+
+    AT_U8* ticks = chunk(inputBuffer, imagesizebytes, CID_TICKS);
+
+    if (ticks == nullptr) {
+        return AT_ERR_NODATA;
+    }
+
+    memcpy(&timeStamp, ticks, 8);
+
+    return AT_SUCCESS;
+
+}
+
+int AT_EXP_CONV AT_GetIRIGFromMetadata(AT_U8* inputBuffer, AT_64 imagesizebytes, AT_64* seconds, AT_64* minutes, AT_64* hours, AT_64* days, AT_64* years) {
+    return AT_ERR_NODATA;
+}
+
+int AT_EXP_CONV AT_GetExtendedIRIGFromMetadata(AT_U8* inputBuffer, AT_64 imagesizebytes, AT_64 clockfrequency, double* nanoseconds, AT_64* seconds, AT_64* minutes, AT_64* hours, AT_64* days, AT_64* years) {
+    return AT_ERR_NODATA;
+}
+
+int AT_EXP_CONV AT_ConfigureSpooling(AT_H camera, const AT_WC* format, const AT_WC* path) {
+    return AT_ERR_NOTIMPLEMENTED;
+}
+
+int AT_EXP_CONV AT_GetSpoolProgress(AT_H camera, int * imageNumber) {
+    return AT_ERR_NOTIMPLEMENTED;
+}
+
+int AT_EXP_CONV AT_GetMostRecentImage(AT_H camera, AT_U8* buffer, int bufferSize) {
+    return AT_ERR_NOTIMPLEMENTED;
+}
+
+}
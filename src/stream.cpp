@@ -0,0 +1,209 @@
+#pragma once
+#include "frame.cpp"
+#include "format.cpp"
+#include "compress.cpp"
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+
+using namespace std;
+
+/// @brief A copy of one frame as A3C writes it (Mono16, or 32-bit totals or Float32
+/// pixels, depending on what the pipeline is doing), handed out by a FrameStream.
+/// Copies share the same pixels. A default-constructed one holds no frame.
+class StreamFrame {
+
+    private:
+
+        shared_ptr<unsigned char[]> data;
+        long      sequence  = -1;
+        long long timestamp = 0;
+        long      frequency = 0;
+        int       status    = 0;
+        long      width     = 0;
+        long      height    = 0;
+        string    encoding;
+
+    public:
+
+        StreamFrame() {}
+
+        /// @brief Copies out the pixels of a frame laid out as given, decompressing
+        /// them if need be.
+        StreamFrame(Frame& frame, A3CHeader& layout, long clockFrequency) {
+
+            long bytes = layout.frameBytes();
+
+            data      = shared_ptr<unsigned char[]>(new unsigned char[bytes]);
+            sequence  = frame.sequence;
+            timestamp = frame.metadata.timestamp;
+            frequency = clockFrequency;
+            status    = frame.status;
+            width     = layout.width;
+            height    = layout.height;
+            encoding  = string(layout.encoding, strnlen(layout.encoding, sizeof(layout.encoding)));
+
+            // Shouldn't happen, but this runs inside the pipeline so mustn't throw
+            if (frame.packed != nullptr) {
+
+                if (!deltapackDecompress(frame.packed, frame.packedBytes, (uint16_t*) data.get(), bytes / 2)) {
+                    memset(data.get(), 0, bytes);
+                    status |= FRAME_CONVERSION_FAILED;
+                }
+
+            } else {
+                memcpy(data.get(), frame.data, bytes);
+            }
+
+        }
+
+        bool isValid() {
+            return sequence >= 0;
+        }
+
+        long getSequence() {
+            return sequence;
+        }
+
+        /// @brief Hardware timestamp, in clock ticks.
+        long long getTimestamp() {
+            return timestamp;
+        }
+
+        /// @brief Hardware timestamp, in seconds.
+        double getTime() {
+            return frequency > 0 ? (double) timestamp / frequency : 0.0;
+        }
+
+        int getStatus() {
+            return status;
+        }
+
+        long getWidth() {
+            return width;
+        }
+
+        long getHeight() {
+            return height;
+        }
+
+        /// @brief "Mono16", "Mono32" or "Float32".
+        string getEncoding() {
+            return encoding;
+        }
+
+        /// @brief The pixels, for as long as something holds on to the returned pointer.
+        shared_ptr<unsigned char[]> share() {
+            return data;
+        }
+
+};
+
+/// @brief Hands a copy of every nth frame out of the A3C pipeline to whoever is
+/// watching, through a small buffer that drops its oldest frame rather than ever
+/// holding up the pipeline when it's full. It is opened when the pipeline starts,
+/// and closed once it has stopped, after which what's left can still be taken out.
+class FrameStream {
+
+    private:
+
+        mutex               lock;
+        condition_variable  ready;
+        deque<StreamFrame>  frames;
+        long                interval = 0;
+        long                depth    = 1;
+        long                count    = 0;
+        long                dropped  = 0;
+        bool                open     = false;
+
+    public:
+
+        /// @brief Starts taking every interval-th frame (or none, if interval is zero),
+        /// keeping at most depth of them.
+        void start(long interval, long depth) {
+
+            lock_guard<mutex> guard(lock);
+
+            this->interval = interval;
+            this->depth    = depth > 0 ? depth : 1;
+            this->count    = 0;
+            this->dropped  = 0;
+            this->open     = interval > 0;
+
+            frames.clear();
+
+        }
+
+        /// @brief Stops taking frames, waking anyone waiting for one.
+        void stop() {
+
+            {
+                lock_guard<mutex> guard(lock);
+                open = false;
+            }
+
+            ready.notify_all();
+
+        }
+
+        /// @brief Whether the next frame should be pushed. Only to be called from the
+        /// one thread pushing frames.
+        bool isDue() {
+            return open && count++ % interval == 0;
+        }
+
+        void push(StreamFrame frame) {
+
+            {
+                lock_guard<mutex> guard(lock);
+
+                if ((long) frames.size() >= depth) {
+                    frames.pop_front();
+                    dropped++;
+                }
+
+                frames.push_back(frame);
+            }
+
+            ready.notify_one();
+
+        }
+
+        /// @brief Waits up to timeout ms for the next frame, returning an invalid one if
+        /// none came or the stream is closed with nothing left in it.
+        StreamFrame pop(long timeout) {
+
+            unique_lock<mutex> guard(lock);
+
+            ready.wait_for(guard, chrono::milliseconds(timeout), [this]() {
+                return !frames.empty() || !open;
+            });
+
+            if (frames.empty()) {
+                return StreamFrame();
+            }
+
+            StreamFrame frame = frames.front();
+            frames.pop_front();
+
+            return frame;
+
+        }
+
+        /// @brief Whether there are frames yet to be taken out, or still to come.
+        bool isOpen() {
+            lock_guard<mutex> guard(lock);
+            return open || !frames.empty();
+        }
+
+        /// @brief Frames pushed out of the buffer before being taken, since it was started.
+        long getDropped() {
+            lock_guard<mutex> guard(lock);
+            return dropped;
+        }
+
+};
@@ -0,0 +1,971 @@
+#pragma once
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <string>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define A3C_HAVE_PWRITE
+#include <fcntl.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
+#if defined(A3C_HAVE_PWRITE) && defined(O_DIRECT)
+#define A3C_HAVE_DIRECT
+#endif
+
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+#define A3C_HAVE_URING
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#endif
+
+using namespace std;
+
+// Default size of each submission, and number of them kept in flight, for the io_uring writer
+#define URING_BATCH_BYTES (8L * 1024 * 1024)
+#define URING_DEPTH       8
+#define URING_MAX_IOV     256
+
+// How far ahead to reserve disk space when the final size of a file isn't known
+#define PREALLOCATE_CHUNK_BYTES (1L << 30)
+
+// Block size that O_DIRECT writes are aligned and padded to, and size of each write
+#define DIRECT_ALIGNMENT   4096L
+#define DIRECT_CHUNK_BYTES (8L * 1024 * 1024)
+
+/// @brief Destination for the frames coming out of the A3C pipeline. Frames are
+/// appended one after the other, starting at the offset given to open(), with
+/// anything else (i.e., the file header) written separately through writeAt().
+/// A writer takes ownership of each buffer passed to write() and hands it to the
+/// release function once it has finished with it, which for an asynchronous
+/// writer can be some time after write() returns.
+class Writer {
+
+    protected:
+
+        function<void(unsigned char*)> release;
+        string                         error;
+        long                           position = 0;
+
+    public:
+
+        Writer(function<void(unsigned char*)> release) : release(release) {}
+
+        virtual ~Writer() {}
+
+        virtual bool open(string path, long start) = 0;
+
+        virtual bool write(unsigned char* data, long bytes) = 0;
+
+        virtual bool writeAt(const void* data, long bytes, long offset) = 0;
+
+        /// @brief Asks for disk space to be reserved up-front, once open: expected
+        /// bytes straight away (if known), then chunk bytes at a time as the file
+        /// grows beyond that. Any space reserved past the end is given back on close().
+        virtual void preallocate(long /* expected */, long /* chunk */) {}
+
+        /// @brief Waits for every outstanding write to complete.
+        virtual bool flush() = 0;
+
+        virtual void close() = 0;
+
+        virtual string getName() = 0;
+
+        string getError() {
+            return error;
+        }
+
+};
+
+/// @brief Reserves disk space for a file ahead of it being written, so that it
+/// ends up in as few extents as possible and the filesystem isn't allocating
+/// blocks on every append. Space is reserved without changing the file size, so
+/// the file always looks exactly as long as what has actually been written, and
+/// whatever is left over past the end is released by finish(). Only does anything
+/// on Linux, and quietly gives up if the filesystem can't do it.
+class Preallocator {
+
+    private:
+
+        int  file     = -1;
+        long reserved = 0;
+        long step     = 0;
+
+    public:
+
+        void attach(int descriptor, long expected, long chunk) {
+
+            file     = descriptor;
+            reserved = 0;
+            step     = chunk;
+
+            if (expected > 0) {
+                reserve(expected);
+            }
+
+        }
+
+        /// @brief Makes sure everything up to end is reserved, growing by at least
+        /// one chunk at a time.
+        void reserve(long end) {
+
+            if (file < 0 || end <= reserved) {
+                return;
+            }
+
+            long target = reserved + step > end ? reserved + step : end;
+
+#if defined(__linux__)
+            if (fallocate(file, FALLOC_FL_KEEP_SIZE, reserved, target - reserved) != 0) {
+                file = -1;
+                return;
+            }
+#endif
+
+            reserved = target;
+
+        }
+
+        void finish(long size) {
+
+#if defined(A3C_HAVE_PWRITE)
+            if (file >= 0 && reserved > size) {
+                (void) ftruncate(file, size);
+            }
+#endif
+
+            file     = -1;
+            reserved = 0;
+
+        }
+
+};
+
+/// @brief Synchronous writer using an ofstream, as A3C always has. Works anywhere.
+class StreamWriter : public Writer {
+
+    private:
+
+        ofstream     output;
+        Preallocator space;
+        int          file = -1;
+
+    public:
+
+        using Writer::Writer;
+
+        ~StreamWriter() {
+            close();
+        }
+
+        bool open(string path, long start) {
+
+#if defined(A3C_HAVE_PWRITE)
+            // Create the file ourselves, keeping a descriptor to reserve space through,
+            // and open the stream on it afterwards without truncating it again
+            file = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+            output.open(path, ios::binary | ios::in | ios::out);
+#else
+            output.open(path, ios::binary | ios::out | ios::trunc);
+#endif
+
+            output.seekp(start);
+
+            position = start;
+
+            if (!output) {
+                error = "Could not open " + path;
+            }
+
+            return (bool) output;
+
+        }
+
+        void preallocate(long expected, long chunk) {
+            space.attach(file, expected, chunk);
+        }
+
+        bool write(unsigned char* data, long bytes) {
+
+            space.reserve(position + bytes);
+
+            output.write((const char*) data, bytes);
+            release(data);
+
+            position += bytes;
+
+            return (bool) output;
+
+        }
+
+        bool writeAt(const void* data, long bytes, long offset) {
+
+            output.seekp(offset);
+            output.write((const char*) data, bytes);
+            output.seekp(position);
+
+            return (bool) output;
+
+        }
+
+        bool flush() {
+            output.flush();
+            return (bool) output;
+        }
+
+        void close() {
+
+            if (output.is_open()) {
+                output.close();
+                space.finish(position);
+            }
+
+#if defined(A3C_HAVE_PWRITE)
+            if (file >= 0) {
+                ::close(file);
+                file = -1;
+            }
+#endif
+
+        }
+
+        string getName() {
+            return "stream";
+        }
+
+};
+
+#if defined(A3C_HAVE_PWRITE)
+
+/// @brief Synchronous writer going straight to the file descriptor with pwrite(),
+/// without the extra copy and buffering of an ofstream.
+class PWriteWriter : public Writer {
+
+    protected:
+
+        int          file = -1;
+        Preallocator space;
+
+        bool writeFully(const void* data, long bytes, long offset) {
+
+            const unsigned char* from = (const unsigned char*) data;
+
+            while (bytes > 0) {
+
+                ssize_t done = pwrite(file, from, bytes, offset);
+
+                if (done < 0 && errno == EINTR) {
+                    continue;
+                }
+
+                if (done <= 0) {
+                    error = string("pwrite failed: ") + strerror(errno);
+                    return false;
+                }
+
+                from   += done;
+                bytes  -= done;
+                offset += done;
+
+            }
+
+            return true;
+
+        }
+
+    public:
+
+        using Writer::Writer;
+
+        ~PWriteWriter() {
+            close();
+        }
+
+        bool open(string path, long start) {
+
+            file     = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+            position = start;
+
+            if (file < 0) {
+                error = "Could not open " + path + ": " + strerror(errno);
+                return false;
+            }
+
+            return true;
+
+        }
+
+        void preallocate(long expected, long chunk) {
+            space.attach(file, expected, chunk);
+        }
+
+        bool write(unsigned char* data, long bytes) {
+
+            space.reserve(position + bytes);
+
+            bool ok = writeFully(data, bytes, position);
+
+            release(data);
+            position += bytes;
+
+            return ok;
+
+        }
+
+        bool writeAt(const void* data, long bytes, long offset) {
+            return writeFully(data, bytes, offset);
+        }
+
+        bool flush() {
+            return true;
+        }
+
+        void close() {
+
+            if (file >= 0) {
+                space.finish(position);
+                ::close(file);
+                file = -1;
+            }
+
+        }
+
+        string getName() {
+            return "pwrite";
+        }
+
+};
+
+#endif
+
+#if defined(A3C_HAVE_DIRECT)
+
+/// @brief Writer that bypasses the page cache with O_DIRECT, so that long captures
+/// don't push everything else out of memory and then stall on writeback. Frames are
+/// packed back-to-back into a DIRECT_ALIGNMENT-aligned staging buffer which is
+/// written out DIRECT_CHUNK_BYTES at a time, always in whole blocks. Whatever is
+/// left over on flush() is padded out to a whole block, and close() truncates the
+/// file back down to its real size. Anything written with writeAt() over data
+/// already on disk is done by reading, patching and re-writing the blocks it covers.
+/// If the filesystem refuses O_DIRECT (e.g., tmpfs) the same path is used with
+/// ordinary buffered writes instead.
+class DirectWriter : public PWriteWriter {
+
+    private:
+
+        unsigned char* staging = nullptr;
+        long           base    = 0;
+        long           filled  = 0;
+        bool           direct  = false;
+
+        static long alignDown(long value) {
+            return value & ~(DIRECT_ALIGNMENT - 1);
+        }
+
+        static long alignUp(long value) {
+            return alignDown(value + DIRECT_ALIGNMENT - 1);
+        }
+
+        /// @brief Writes out every whole block in the staging buffer (and the partial
+        /// one at the end, padded, if asked to), then moves that partial block to the
+        /// front so later frames carry on filling it.
+        bool drain(bool padTail) {
+
+            long whole = alignDown(filled);
+            long tail  = filled - whole;
+            long bytes = whole;
+
+            if (padTail && tail > 0) {
+                memset(staging + filled, 0, DIRECT_ALIGNMENT - tail);
+                bytes += DIRECT_ALIGNMENT;
+            }
+
+            if (bytes > 0 && !writeFully(staging, bytes, base)) {
+                return false;
+            }
+
+            if (whole > 0) {
+                memmove(staging, staging + whole, tail);
+                base   += whole;
+                filled  = tail;
+            }
+
+            return true;
+
+        }
+
+        /// @brief Patches bytes that have already been written out, a block at a time.
+        bool patch(const unsigned char* data, long bytes, long offset) {
+
+            long first = alignDown(offset);
+            long size  = alignUp(offset + bytes) - first;
+
+            void* block;
+
+            if (posix_memalign(&block, DIRECT_ALIGNMENT, size) != 0) {
+                error = "Could not allocate aligned buffer";
+                return false;
+            }
+
+            memset(block, 0, size);
+
+            bool ok = pread(file, block, size, first) >= 0;
+
+            if (ok) {
+                memcpy((unsigned char*) block + (offset - first), data, bytes);
+                ok = writeFully(block, size, first);
+            } else {
+                error = string("pread failed: ") + strerror(errno);
+            }
+
+            free(block);
+
+            return ok;
+
+        }
+
+    public:
+
+        using PWriteWriter::PWriteWriter;
+
+        ~DirectWriter() {
+            close();
+        }
+
+        bool open(string path, long start) {
+
+            file   = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_DIRECT, 0644);
+            direct = file >= 0;
+
+            if (file < 0 && errno == EINVAL) {
+                file = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+            }
+
+            if (file < 0) {
+                error = "Could not open " + path + ": " + strerror(errno);
+                return false;
+            }
+
+            if (posix_memalign((void**) &staging, DIRECT_ALIGNMENT, DIRECT_CHUNK_BYTES) != 0) {
+                staging = nullptr;
+                error   = "Could not allocate aligned buffer";
+                return false;
+            }
+
+            // Start staging from the block that the first frame falls in
+            position = start;
+            base     = alignDown(start);
+            filled   = start - base;
+
+            memset(staging, 0, filled);
+
+            return true;
+
+        }
+
+        bool write(unsigned char* data, long bytes) {
+
+            bool           ok   = staging != nullptr;
+            unsigned char* from = data;
+            long           left = bytes;
+
+            space.reserve(position + bytes);
+
+            while (ok && left > 0) {
+
+                long room  = DIRECT_CHUNK_BYTES - filled;
+                long count = left < room ? left : room;
+
+                memcpy(staging + filled, from, count);
+
+                filled += count;
+                from   += count;
+                left   -= count;
+
+                if (filled == DIRECT_CHUNK_BYTES) {
+                    ok = drain(false);
+                }
+
+            }
+
+            // Everything has been copied out by now, so the frame can go straight back
+            release(data);
+            position += bytes;
+
+            return ok;
+
+        }
+
+        bool writeAt(const void* data, long bytes, long offset) {
+
+            const unsigned char* from = (const unsigned char*) data;
+
+            if (staging == nullptr) {
+                return false;
+            }
+
+            // Anything before the staging buffer is already on disk
+            if (offset < base) {
+
+                long before = offset + bytes < base ? bytes : base - offset;
+
+                if (!patch(from, before, offset)) {
+                    return false;
+                }
+
+                from   += before;
+                bytes  -= before;
+                offset += before;
+
+            }
+
+            if (bytes > 0) {
+
+                memcpy(staging + (offset - base), from, bytes);
+
+                if (offset - base + bytes > filled) {
+                    filled = offset - base + bytes;
+                }
+
+            }
+
+            return true;
+
+        }
+
+        bool flush() {
+            return staging == nullptr || drain(true);
+        }
+
+        void close() {
+
+            if (file >= 0 && staging != nullptr) {
+
+                // Drop the padding written after the last frame (and any space reserved past it)
+                if (!drain(true) || ftruncate(file, position) != 0) {
+                    error = string("Could not finish file: ") + strerror(errno);
+                }
+
+            }
+
+            free(staging);
+            staging = nullptr;
+
+            PWriteWriter::close();
+
+        }
+
+        string getName() {
+            return direct || file < 0 ? "direct" : "pwrite";
+        }
+
+};
+
+#endif
+
+#if defined(A3C_HAVE_URING)
+
+/// @brief Asynchronous writer using io_uring. Frames are gathered into batches of
+/// around URING_BATCH_BYTES, each submitted as a single vectored write, with up to
+/// URING_DEPTH batches in flight at once, so write() only ever blocks once all of
+/// them are still outstanding. Buffers are only released once the write holding
+/// them has completed. If io_uring can't be set up (old kernel, or blocked by
+/// seccomp etc.) it quietly behaves exactly as PWriteWriter instead.
+class UringWriter : public PWriteWriter {
+
+    private:
+
+        /// @brief One vectored write, and the frame buffers it covers.
+        struct Batch {
+
+            vector<iovec>          iov;
+            vector<unsigned char*> buffers;
+            long                   offset  = 0;
+            long                   bytes   = 0;
+            size_t                 first   = 0;
+            bool                   pending = false;
+
+        };
+
+        int       ring     = -1;
+        unsigned  entries  = 0;
+        unsigned* sqHead   = nullptr;
+        unsigned* sqTail   = nullptr;
+        unsigned* sqMask   = nullptr;
+        unsigned* sqArray  = nullptr;
+        unsigned* cqHead   = nullptr;
+        unsigned* cqTail   = nullptr;
+        unsigned* cqMask   = nullptr;
+        void*     sqMemory = nullptr;
+        void*     cqMemory = nullptr;
+        size_t    sqBytes  = 0;
+        size_t    cqBytes  = 0;
+        size_t    sqeBytes = 0;
+
+        io_uring_sqe* sqes = nullptr;
+        io_uring_cqe* cqes = nullptr;
+
+        vector<Batch> batches;
+        int           current  = 0;
+        int           inFlight = 0;
+        long          batchBytes;
+
+        bool setup() {
+
+            io_uring_params params;
+            memset(&params, 0, sizeof(params));
+
+            ring = (int) syscall(__NR_io_uring_setup, URING_DEPTH, &params);
+
+            if (ring < 0) {
+                return false;
+            }
+
+            entries = params.sq_entries;
+            sqBytes = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+            cqBytes = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+
+            bool single = params.features & IORING_FEAT_SINGLE_MMAP;
+
+            if (single) {
+                sqBytes = cqBytes = sqBytes > cqBytes ? sqBytes : cqBytes;
+            }
+
+            sqMemory = mmap(nullptr, sqBytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring, IORING_OFF_SQ_RING);
+            cqMemory = single ? sqMemory : mmap(nullptr, cqBytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring, IORING_OFF_CQ_RING);
+            sqeBytes = params.sq_entries * sizeof(io_uring_sqe);
+            sqes     = (io_uring_sqe*) mmap(nullptr, sqeBytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring, IORING_OFF_SQES);
+
+            if (sqMemory == MAP_FAILED || cqMemory == MAP_FAILED || sqes == MAP_FAILED) {
+                sqes = nullptr;
+                teardown();
+                return false;
+            }
+
+            unsigned char* sq = (unsigned char*) sqMemory;
+            unsigned char* cq = (unsigned char*) cqMemory;
+
+            sqHead  = (unsigned*) (sq + params.sq_off.head);
+            sqTail  = (unsigned*) (sq + params.sq_off.tail);
+            sqMask  = (unsigned*) (sq + params.sq_off.ring_mask);
+            sqArray = (unsigned*) (sq + params.sq_off.array);
+            cqHead  = (unsigned*) (cq + params.cq_off.head);
+            cqTail  = (unsigned*) (cq + params.cq_off.tail);
+            cqMask  = (unsigned*) (cq + params.cq_off.ring_mask);
+            cqes    = (io_uring_cqe*) (cq + params.cq_off.cqes);
+
+            return true;
+
+        }
+
+        void teardown() {
+
+            if (sqes != nullptr && sqes != MAP_FAILED) {
+                munmap(sqes, sqeBytes);
+            }
+
+            if (cqMemory != nullptr && cqMemory != MAP_FAILED && cqMemory != sqMemory) {
+                munmap(cqMemory, cqBytes);
+            }
+
+            if (sqMemory != nullptr && sqMemory != MAP_FAILED) {
+                munmap(sqMemory, sqBytes);
+            }
+
+            if (ring >= 0) {
+                ::close(ring);
+            }
+
+            ring     = -1;
+            sqes     = nullptr;
+            sqMemory = nullptr;
+            cqMemory = nullptr;
+
+        }
+
+        /// @brief Queues a vectored write of whatever is left of a batch.
+        bool submit(int index) {
+
+            Batch&   batch = batches[index];
+            unsigned tail  = *sqTail;
+            unsigned slot  = tail & *sqMask;
+
+            io_uring_sqe* sqe = &sqes[slot];
+
+            memset(sqe, 0, sizeof(io_uring_sqe));
+
+            sqe->opcode    = IORING_OP_WRITEV;
+            sqe->fd        = file;
+            sqe->addr      = (unsigned long long) (batch.iov.data() + batch.first);
+            sqe->len       = (unsigned) (batch.iov.size() - batch.first);
+            sqe->off       = (unsigned long long) batch.offset;
+            sqe->user_data = (unsigned long long) index;
+
+            sqArray[slot] = slot;
+
+            __atomic_store_n(sqTail, tail + 1, __ATOMIC_RELEASE);
+
+            int result;
+
+            do {
+                result = (int) syscall(__NR_io_uring_enter, ring, 1, 0, 0, nullptr, 0);
+            } while (result < 0 && errno == EINTR);
+
+            if (result < 0) {
+                error = string("io_uring submission failed: ") + strerror(errno);
+                return false;
+            }
+
+            batch.pending = true;
+            inFlight++;
+
+            return true;
+
+        }
+
+        /// @brief Waits for at least one write to complete and deals with everything
+        /// that has, releasing the buffers of finished batches and resubmitting the
+        /// remainder of any that were only partly written.
+        bool reap() {
+
+            int result;
+
+            do {
+                result = (int) syscall(__NR_io_uring_enter, ring, 0, 1, IORING_ENTER_GETEVENTS, nullptr, 0);
+            } while (result < 0 && errno == EINTR);
+
+            if (result < 0) {
+                error = string("io_uring wait failed: ") + strerror(errno);
+                return false;
+            }
+
+            bool     ok   = true;
+            unsigned head = *cqHead;
+            unsigned tail = __atomic_load_n(cqTail, __ATOMIC_ACQUIRE);
+
+            for (; head != tail; head++) {
+
+                io_uring_cqe* cqe   = &cqes[head & *cqMask];
+                int           index = (int) cqe->user_data;
+                long          done  = cqe->res;
+                Batch&        batch = batches[index];
+
+                batch.pending = false;
+                inFlight--;
+
+                if (done < 0) {
+                    error = string("io_uring write failed: ") + strerror((int) -done);
+                    ok    = false;
+                    finish(index);
+                    continue;
+                }
+
+                batch.bytes  -= done;
+                batch.offset += done;
+
+                // Short write, so skip past what did get written and go again
+                if (batch.bytes > 0) {
+
+                    while (done >= (long) batch.iov[batch.first].iov_len) {
+                        done -= (long) batch.iov[batch.first].iov_len;
+                        batch.first++;
+                    }
+
+                    batch.iov[batch.first].iov_base  = (unsigned char*) batch.iov[batch.first].iov_base + done;
+                    batch.iov[batch.first].iov_len  -= done;
+
+                    __atomic_store_n(cqHead, head + 1, __ATOMIC_RELEASE);
+
+                    ok = submit(index) && ok;
+
+                    continue;
+
+                }
+
+                finish(index);
+
+            }
+
+            __atomic_store_n(cqHead, head, __ATOMIC_RELEASE);
+
+            return ok;
+
+        }
+
+        void finish(int index) {
+
+            Batch& batch = batches[index];
+
+            for (unsigned char* buffer : batch.buffers) {
+                release(buffer);
+            }
+
+            batch.iov.clear();
+            batch.buffers.clear();
+            batch.bytes = 0;
+            batch.first = 0;
+
+        }
+
+        /// @brief Sends off the batch currently being filled and moves on to the next
+        /// free one, waiting for one to free up if they are all in flight.
+        bool rotate() {
+
+            bool ok = true;
+
+            if (batches[current].bytes > 0) {
+                ok      = submit(current);
+                current = (current + 1) % (int) batches.size();
+            }
+
+            while (ok && batches[current].pending) {
+                ok = reap();
+            }
+
+            batches[current].offset = position;
+
+            return ok;
+
+        }
+
+    public:
+
+        UringWriter(function<void(unsigned char*)> release, long batchBytes = URING_BATCH_BYTES) : PWriteWriter(release), batchBytes(batchBytes) {}
+
+        ~UringWriter() {
+            close();
+        }
+
+        bool open(string path, long start) {
+
+            if (!PWriteWriter::open(path, start)) {
+                return false;
+            }
+
+            if (setup()) {
+                batches.assign(entries < URING_DEPTH ? entries : URING_DEPTH, Batch());
+                current                 = 0;
+                inFlight                = 0;
+                batches[current].offset = start;
+            }
+
+            return true;
+
+        }
+
+        bool write(unsigned char* data, long bytes) {
+
+            if (ring < 0) {
+                return PWriteWriter::write(data, bytes);
+            }
+
+            Batch& batch = batches[current];
+
+            space.reserve(position + bytes);
+
+            batch.iov.push_back({data, (size_t) bytes});
+            batch.buffers.push_back(data);
+            batch.bytes += bytes;
+            position    += bytes;
+
+            if (batch.bytes >= batchBytes || batch.iov.size() >= URING_MAX_IOV) {
+                return rotate();
+            }
+
+            return true;
+
+        }
+
+        bool flush() {
+
+            if (ring < 0) {
+                return true;
+            }
+
+            bool ok = rotate();
+
+            while (inFlight > 0) {
+                ok = reap() && ok;
+            }
+
+            return ok;
+
+        }
+
+        void close() {
+
+            if (ring >= 0) {
+                flush();
+                teardown();
+            }
+
+            PWriteWriter::close();
+
+        }
+
+        string getName() {
+            return ring >= 0 || file < 0 ? "uring" : "pwrite";
+        }
+
+};
+
+#endif
+
+/// @brief Lists the writer backends that can be asked for on this platform ("uring"
+/// falls back to pwrite wherever io_uring itself isn't available).
+vector<string> writerBackends() {
+
+    vector<string> names = {"stream"};
+
+#if defined(A3C_HAVE_PWRITE)
+    names.push_back("pwrite");
+    names.push_back("uring");
+#endif
+
+#if defined(A3C_HAVE_DIRECT)
+    names.push_back("direct");
+#endif
+
+    return names;
+
+}
+
+/// @brief Creates a writer by name, or returns nullptr if there is no such backend
+/// on this platform.
+Writer* createWriter(string backend, function<void(unsigned char*)> release) {
+
+    if (backend == "stream") {
+        return new StreamWriter(release);
+    }
+
+#if defined(A3C_HAVE_PWRITE)
+    if (backend == "pwrite") {
+        return new PWriteWriter(release);
+    }
+#endif
+
+#if defined(A3C_HAVE_URING)
+    if (backend == "uring") {
+        return new UringWriter(release);
+    }
+#elif defined(A3C_HAVE_PWRITE)
+    if (backend == "uring") {
+        return new PWriteWriter(release);
+    }
+#endif
+
+#if defined(A3C_HAVE_DIRECT)
+    if (backend == "direct") {
+        return new DirectWriter(release);
+    }
+#endif
+
+    return nullptr;
+
+}